@@ -0,0 +1,342 @@
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string.h>
+#include <unordered_map>
+#include <vector>
+
+extern "C"
+{
+#include "sg_allocator.h"
+#include "sg_vector.h"
+#include "sg_hash_table.h"
+}
+
+// Every sg benchmark has a std baseline registered next to it under the same arguments.
+// Run with --benchmark_out=<file> --benchmark_out_format=json to keep results for comparison between releases.
+
+namespace sg
+{
+    namespace bench
+    {
+        // Element of a given byte size so strides sweep the same way for both containers
+        template<sg_u32 STRIDE>
+        struct payload
+        {
+            sg_u8 bytes[STRIDE];
+        };
+
+        template<sg_u32 STRIDE>
+        static payload<STRIDE> make_payload(sg_u32 i)
+        {
+            payload<STRIDE> element;
+            memset(element.bytes, (int)i, STRIDE);
+            return element;
+        }
+
+        // Distinct shuffled keys, hits have the low bit clear and misses have it set
+        static std::vector<sg_u32> make_keys(sg_u32 count, sg_u32 miss)
+        {
+            std::vector<sg_u32> keys(count);
+            for (sg_u32 i = 0; i < count; ++i)
+                keys[i] = (i << 1) | miss;
+
+            std::mt19937 rng(count);
+            std::shuffle(keys.begin(), keys.end(), rng);
+            return keys;
+        }
+
+        static sg_f32 load_factor_arg(const benchmark::State& state)
+        {
+            return (sg_f32)state.range(1) / 100.0f;
+        }
+
+        static const sg_u32 ERASE_COUNT = 256;
+
+        /* sg_vector */
+
+        template<sg_u32 STRIDE>
+        static void vector_push_sg(benchmark::State& state)
+        {
+            sg_u32 count = (sg_u32)state.range(0);
+            payload<STRIDE> element = make_payload<STRIDE>(1);
+            for (auto _ : state)
+            {
+                sg_vector vector = sg_vector_create(0, STRIDE, NULL);
+                for (sg_u32 i = 0; i < count; ++i)
+                    sg_vector_push(&vector, &element);
+
+                benchmark::DoNotOptimize(vector._buffer.allocation);
+                sg_vector_destroy(&vector);
+            }
+
+            state.SetItemsProcessed(state.iterations() * count);
+        }
+
+        template<sg_u32 STRIDE>
+        static void vector_push_std(benchmark::State& state)
+        {
+            sg_u32 count = (sg_u32)state.range(0);
+            payload<STRIDE> element = make_payload<STRIDE>(1);
+            for (auto _ : state)
+            {
+                std::vector<payload<STRIDE>> vector;
+                for (sg_u32 i = 0; i < count; ++i)
+                    vector.push_back(element);
+
+                benchmark::DoNotOptimize(vector.data());
+            }
+
+            state.SetItemsProcessed(state.iterations() * count);
+        }
+
+        template<sg_u32 STRIDE>
+        static void vector_emplace_sg(benchmark::State& state)
+        {
+            sg_u32 count = (sg_u32)state.range(0);
+            for (auto _ : state)
+            {
+                sg_vector vector = sg_vector_create(0, STRIDE, NULL);
+                for (sg_u32 i = 0; i < count; ++i)
+                    ((payload<STRIDE>*)sg_vector_emplace(&vector))->bytes[0] = (sg_u8)i;
+
+                benchmark::DoNotOptimize(vector._buffer.allocation);
+                sg_vector_destroy(&vector);
+            }
+
+            state.SetItemsProcessed(state.iterations() * count);
+        }
+
+        template<sg_u32 STRIDE>
+        static void vector_emplace_std(benchmark::State& state)
+        {
+            sg_u32 count = (sg_u32)state.range(0);
+            for (auto _ : state)
+            {
+                std::vector<payload<STRIDE>> vector;
+                for (sg_u32 i = 0; i < count; ++i)
+                {
+                    vector.emplace_back();
+                    vector.back().bytes[0] = (sg_u8)i;
+                }
+
+                benchmark::DoNotOptimize(vector.data());
+            }
+
+            state.SetItemsProcessed(state.iterations() * count);
+        }
+
+        // Erases from the middle so every call shifts half of what is left, refills are not timed
+        template<sg_u32 STRIDE>
+        static void vector_erase_sg(benchmark::State& state)
+        {
+            sg_u32 count = (sg_u32)state.range(0);
+            payload<STRIDE> element = make_payload<STRIDE>(1);
+            sg_vector vector = sg_vector_create(0, STRIDE, NULL);
+            for (auto _ : state)
+            {
+                state.PauseTiming();
+                while (sg_vector_size(&vector) < count)
+                    sg_vector_push(&vector, &element);
+                state.ResumeTiming();
+
+                for (sg_u32 i = 0; i < ERASE_COUNT; ++i)
+                    sg_vector_erase(&vector, sg_vector_size(&vector) / 2);
+            }
+
+            sg_vector_destroy(&vector);
+            state.SetItemsProcessed(state.iterations() * ERASE_COUNT);
+        }
+
+        template<sg_u32 STRIDE>
+        static void vector_erase_std(benchmark::State& state)
+        {
+            sg_u32 count = (sg_u32)state.range(0);
+            payload<STRIDE> element = make_payload<STRIDE>(1);
+            std::vector<payload<STRIDE>> vector;
+            for (auto _ : state)
+            {
+                state.PauseTiming();
+                vector.resize(count, element);
+                state.ResumeTiming();
+
+                for (sg_u32 i = 0; i < ERASE_COUNT; ++i)
+                    vector.erase(vector.begin() + vector.size() / 2);
+            }
+
+            state.SetItemsProcessed(state.iterations() * ERASE_COUNT);
+        }
+
+        /* sg_hash_table */
+
+        template<sg_u32 STRIDE>
+        static void hash_table_fill_sg(sg_hash_table* p_table, const std::vector<sg_u32>& keys)
+        {
+            payload<STRIDE> element = make_payload<STRIDE>(1);
+            for (sg_u32 key : keys)
+                sg_hash_table_insert(p_table, key, &element);
+        }
+
+        template<sg_u32 STRIDE>
+        static void hash_table_fill_std(std::unordered_map<sg_u32, payload<STRIDE>>& table, const std::vector<sg_u32>& keys)
+        {
+            payload<STRIDE> element = make_payload<STRIDE>(1);
+            for (sg_u32 key : keys)
+                table.emplace(key, element);
+        }
+
+        // Starts empty so growth at the given load factor is part of the cost
+        template<sg_u32 STRIDE>
+        static void hash_table_insert_sg(benchmark::State& state)
+        {
+            std::vector<sg_u32> keys = make_keys((sg_u32)state.range(0), 0);
+            for (auto _ : state)
+            {
+                sg_hash_table table = sg_hash_table_create(0, STRIDE, load_factor_arg(state), NULL);
+                hash_table_fill_sg<STRIDE>(&table, keys);
+                benchmark::DoNotOptimize(table._ctrl);
+                sg_hash_table_destroy(&table);
+            }
+
+            state.SetItemsProcessed(state.iterations() * keys.size());
+        }
+
+        template<sg_u32 STRIDE>
+        static void hash_table_insert_std(benchmark::State& state)
+        {
+            std::vector<sg_u32> keys = make_keys((sg_u32)state.range(0), 0);
+            for (auto _ : state)
+            {
+                std::unordered_map<sg_u32, payload<STRIDE>> table;
+                table.max_load_factor(load_factor_arg(state));
+                hash_table_fill_std<STRIDE>(table, keys);
+                benchmark::DoNotOptimize(table.size());
+            }
+
+            state.SetItemsProcessed(state.iterations() * keys.size());
+        }
+
+        template<sg_u32 STRIDE>
+        static void hash_table_find_sg(benchmark::State& state, sg_u32 miss)
+        {
+            std::vector<sg_u32> keys = make_keys((sg_u32)state.range(0), 0);
+            std::vector<sg_u32> lookups = make_keys((sg_u32)state.range(0), miss);
+            sg_hash_table table = sg_hash_table_create(0, STRIDE, load_factor_arg(state), NULL);
+            hash_table_fill_sg<STRIDE>(&table, keys);
+
+            for (auto _ : state)
+            {
+                sg_u32 found = 0;
+                for (sg_u32 key : lookups)
+                    found += sg_hash_table_find(&table, key);
+
+                benchmark::DoNotOptimize(found);
+            }
+
+            sg_hash_table_destroy(&table);
+            state.SetItemsProcessed(state.iterations() * lookups.size());
+        }
+
+        template<sg_u32 STRIDE>
+        static void hash_table_find_std(benchmark::State& state, sg_u32 miss)
+        {
+            std::vector<sg_u32> keys = make_keys((sg_u32)state.range(0), 0);
+            std::vector<sg_u32> lookups = make_keys((sg_u32)state.range(0), miss);
+            std::unordered_map<sg_u32, payload<STRIDE>> table;
+            table.max_load_factor(load_factor_arg(state));
+            hash_table_fill_std<STRIDE>(table, keys);
+
+            for (auto _ : state)
+            {
+                sg_u32 found = 0;
+                for (sg_u32 key : lookups)
+                    found += (sg_u32)table.count(key);
+
+                benchmark::DoNotOptimize(found);
+            }
+
+            state.SetItemsProcessed(state.iterations() * lookups.size());
+        }
+
+        template<sg_u32 STRIDE> static void hash_table_find_hit_sg(benchmark::State& state) { hash_table_find_sg<STRIDE>(state, 0); }
+        template<sg_u32 STRIDE> static void hash_table_find_miss_sg(benchmark::State& state) { hash_table_find_sg<STRIDE>(state, 1); }
+        template<sg_u32 STRIDE> static void hash_table_find_hit_std(benchmark::State& state) { hash_table_find_std<STRIDE>(state, 0); }
+        template<sg_u32 STRIDE> static void hash_table_find_miss_std(benchmark::State& state) { hash_table_find_std<STRIDE>(state, 1); }
+
+        // Removes every key from a full table, rebuilding it is not timed
+        template<sg_u32 STRIDE>
+        static void hash_table_remove_sg(benchmark::State& state)
+        {
+            std::vector<sg_u32> keys = make_keys((sg_u32)state.range(0), 0);
+            std::vector<sg_u32> removals = keys;
+            std::shuffle(removals.begin(), removals.end(), std::mt19937(1));
+
+            sg_hash_table table = sg_hash_table_create(0, STRIDE, load_factor_arg(state), NULL);
+            for (auto _ : state)
+            {
+                state.PauseTiming();
+                hash_table_fill_sg<STRIDE>(&table, keys);
+                state.ResumeTiming();
+
+                for (sg_u32 key : removals)
+                    sg_hash_table_remove(&table, key);
+            }
+
+            sg_hash_table_destroy(&table);
+            state.SetItemsProcessed(state.iterations() * removals.size());
+        }
+
+        template<sg_u32 STRIDE>
+        static void hash_table_remove_std(benchmark::State& state)
+        {
+            std::vector<sg_u32> keys = make_keys((sg_u32)state.range(0), 0);
+            std::vector<sg_u32> removals = keys;
+            std::shuffle(removals.begin(), removals.end(), std::mt19937(1));
+
+            std::unordered_map<sg_u32, payload<STRIDE>> table;
+            table.max_load_factor(load_factor_arg(state));
+            for (auto _ : state)
+            {
+                state.PauseTiming();
+                hash_table_fill_std<STRIDE>(table, keys);
+                state.ResumeTiming();
+
+                for (sg_u32 key : removals)
+                    table.erase(key);
+            }
+
+            state.SetItemsProcessed(state.iterations() * removals.size());
+        }
+
+        /* Sweeps */
+
+        static void vector_args(benchmark::internal::Benchmark* p_benchmark)
+        {
+            p_benchmark->ArgName("size")->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+        }
+
+        // Load factors are in percent, sg_hash_table grows past it and std::unordered_map rehashes past it
+        static void hash_table_args(benchmark::internal::Benchmark* p_benchmark)
+        {
+            p_benchmark->ArgNames({ "size", "load" })->ArgsProduct({ { 1 << 10, 1 << 14, 1 << 18 }, { 50, 75, 90 } });
+        }
+
+#define SG_BENCH_STRIDES(name, args)\
+BENCHMARK_TEMPLATE(name, 4)->Apply(args);\
+BENCHMARK_TEMPLATE(name, 16)->Apply(args);\
+BENCHMARK_TEMPLATE(name, 64)->Apply(args);
+
+#define SG_BENCH_PAIR(sg_name, std_name, args)\
+SG_BENCH_STRIDES(sg_name, args)\
+SG_BENCH_STRIDES(std_name, args)
+
+        SG_BENCH_PAIR(vector_push_sg, vector_push_std, vector_args)
+        SG_BENCH_PAIR(vector_emplace_sg, vector_emplace_std, vector_args)
+        SG_BENCH_PAIR(vector_erase_sg, vector_erase_std, vector_args)
+
+        SG_BENCH_PAIR(hash_table_insert_sg, hash_table_insert_std, hash_table_args)
+        SG_BENCH_PAIR(hash_table_find_hit_sg, hash_table_find_hit_std, hash_table_args)
+        SG_BENCH_PAIR(hash_table_find_miss_sg, hash_table_find_miss_std, hash_table_args)
+        SG_BENCH_PAIR(hash_table_remove_sg, hash_table_remove_std, hash_table_args)
+    }
+}
@@ -1,12 +1,24 @@
 #pragma once
 #include "sg_types.h"
 
+// Aligned allocations are made and released through the aligned entry points only. Allocators that leave
+// them NULL get a fallback that over-allocates through allocate and keeps a header in front of the block.
 typedef struct sg_allocator
 {
     void* (*allocate)(sg_u64, void*);
     void  (*free)(void*, void*);
     void* (*realloc)(void*, sg_u64, void*);
     void* p_user_data;
+    void* (*allocate_aligned)(sg_u64, sg_u64, void*);
+    void  (*free_aligned)(void*, void*);
+    void* (*realloc_aligned)(void*, sg_u64, sg_u64, void*);
 } sg_allocator;
 
 extern sg_allocator s_allocator_default;
+
+// Alignment must be a power of two
+void* sg_allocator_allocate_aligned(sg_allocator* p_allocator, sg_u64 size, sg_u64 alignment);
+
+void sg_allocator_free_aligned(sg_allocator* p_allocator, void* p_allocation);
+
+void* sg_allocator_realloc_aligned(sg_allocator* p_allocator, void* p_allocation, sg_u64 size, sg_u64 alignment);
@@ -0,0 +1,60 @@
+#pragma once
+#include "sg_types.h"
+
+typedef struct sg_allocator sg_allocator;
+
+// Allocations are 16 byte aligned and carry their size in the 8 bytes before them for realloc.
+#define SG_ARENA_ALIGNMENT 16U
+#define SG_ARENA_CHUNK_SIZE (64U * 1024U)
+
+typedef struct sg_arena_chunk
+{
+    struct sg_arena_chunk* _prev;
+    sg_u64 _capacity;
+    sg_u64 _offset;
+} sg_arena_chunk;
+
+typedef struct sg_arena_mark
+{
+    sg_arena_chunk* _chunk;
+    sg_u64 _offset;
+} sg_arena_mark;
+
+// Bump allocator over a chain of chunks taken from the parent allocator. Individual frees only
+// reclaim the most recent allocation, memory comes back in bulk through reset, clear and destroy.
+// Chunks released by reset and clear are kept for reuse until destroy.
+typedef struct sg_arena
+{
+    sg_allocator* p_parent;
+    sg_arena_chunk* _chunk;
+    sg_arena_chunk* _free;
+    sg_u64 _chunk_size;
+} sg_arena;
+
+sg_arena sg_arena_create(sg_u64 chunk_size, sg_allocator* p_parent);
+
+void sg_arena_destroy(sg_arena* p_arena);
+
+// An sg_allocator that allocates from the arena, the arena must stay at the same address while it is in use.
+sg_allocator sg_arena_allocator(sg_arena* p_arena);
+
+void* sg_arena_allocate(sg_arena* p_arena, sg_u64 size);
+
+void sg_arena_free(sg_arena* p_arena, void* p_allocation);
+
+void* sg_arena_realloc(sg_arena* p_arena, void* p_allocation, sg_u64 size);
+
+// Alignments below SG_ARENA_ALIGNMENT are raised to it, aligned allocations are freed with sg_arena_free
+void* sg_arena_allocate_aligned(sg_arena* p_arena, sg_u64 size, sg_u64 alignment);
+
+void* sg_arena_realloc_aligned(sg_arena* p_arena, void* p_allocation, sg_u64 size, sg_u64 alignment);
+
+sg_arena_mark sg_arena_get_mark(sg_arena* p_arena);
+
+// Frees everything allocated after the mark was taken
+void sg_arena_reset(sg_arena* p_arena, sg_arena_mark mark);
+
+void sg_arena_clear(sg_arena* p_arena);
+
+// Bytes in use across the chunk chain, including headers and alignment padding
+sg_u64 sg_arena_size(sg_arena* p_arena);
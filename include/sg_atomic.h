@@ -0,0 +1,158 @@
+#pragma once
+#include "sg_types.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#define SG_ATOMIC_PAUSE() _mm_pause()
+#elif defined(_MSC_VER)
+#define SG_ATOMIC_PAUSE() __yield()
+#else
+#define SG_ATOMIC_PAUSE() ((void)0)
+#endif
+
+// Loads acquire, stores release and read-modify-write operations are sequentially consistent.
+
+static inline sg_u32 sg_atomic_load_u32(const volatile sg_u32* p_value)
+{
+#if defined(_MSC_VER)
+    sg_u32 value = *p_value;
+    _ReadWriteBarrier();
+    return value;
+#else
+    return __atomic_load_n(p_value, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline void sg_atomic_store_u32(volatile sg_u32* p_value, sg_u32 value)
+{
+#if defined(_MSC_VER)
+    _InterlockedExchange((volatile long*)p_value, (long)value);
+#else
+    __atomic_store_n(p_value, value, __ATOMIC_RELEASE);
+#endif
+}
+
+static inline sg_u32 sg_atomic_exchange_u32(volatile sg_u32* p_value, sg_u32 value)
+{
+#if defined(_MSC_VER)
+    return (sg_u32)_InterlockedExchange((volatile long*)p_value, (long)value);
+#else
+    return __atomic_exchange_n(p_value, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+// Returns the value held before the operation, the swap happened when it equals expected
+static inline sg_u32 sg_atomic_cas_u32(volatile sg_u32* p_value, sg_u32 expected, sg_u32 desired)
+{
+#if defined(_MSC_VER)
+    return (sg_u32)_InterlockedCompareExchange((volatile long*)p_value, (long)desired, (long)expected);
+#else
+    __atomic_compare_exchange_n(p_value, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return expected;
+#endif
+}
+
+static inline sg_u32 sg_atomic_fetch_add_u32(volatile sg_u32* p_value, sg_u32 value)
+{
+#if defined(_MSC_VER)
+    return (sg_u32)_InterlockedExchangeAdd((volatile long*)p_value, (long)value);
+#else
+    return __atomic_fetch_add(p_value, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static inline sg_u64 sg_atomic_load_u64(const volatile sg_u64* p_value)
+{
+#if defined(_MSC_VER)
+    sg_u64 value = *p_value;
+    _ReadWriteBarrier();
+    return value;
+#else
+    return __atomic_load_n(p_value, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline void sg_atomic_store_u64(volatile sg_u64* p_value, sg_u64 value)
+{
+#if defined(_MSC_VER)
+    _InterlockedExchange64((volatile __int64*)p_value, (__int64)value);
+#else
+    __atomic_store_n(p_value, value, __ATOMIC_RELEASE);
+#endif
+}
+
+// Returns the value held before the operation, the swap happened when it equals expected
+static inline sg_u64 sg_atomic_cas_u64(volatile sg_u64* p_value, sg_u64 expected, sg_u64 desired)
+{
+#if defined(_MSC_VER)
+    return (sg_u64)_InterlockedCompareExchange64((volatile __int64*)p_value, (__int64)desired, (__int64)expected);
+#else
+    __atomic_compare_exchange_n(p_value, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return expected;
+#endif
+}
+
+static inline sg_u64 sg_atomic_fetch_add_u64(volatile sg_u64* p_value, sg_u64 value)
+{
+#if defined(_MSC_VER)
+    return (sg_u64)_InterlockedExchangeAdd64((volatile __int64*)p_value, (__int64)value);
+#else
+    return __atomic_fetch_add(p_value, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static inline void* sg_atomic_load_ptr(void* const volatile* p_value)
+{
+#if defined(_MSC_VER)
+    void* value = *p_value;
+    _ReadWriteBarrier();
+    return value;
+#else
+    return __atomic_load_n(p_value, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline void* sg_atomic_exchange_ptr(void* volatile* p_value, void* value)
+{
+#if defined(_MSC_VER)
+    return _InterlockedExchangePointer(p_value, value);
+#else
+    return __atomic_exchange_n(p_value, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+// Returns the value held before the operation, the swap happened when it equals expected
+static inline void* sg_atomic_cas_ptr(void* volatile* p_value, void* expected, void* desired)
+{
+#if defined(_MSC_VER)
+    return _InterlockedCompareExchangePointer(p_value, desired, expected);
+#else
+    __atomic_compare_exchange_n(p_value, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return expected;
+#endif
+}
+
+// Test and test-and-set lock, contended acquires spin with a pause and then yield the thread
+typedef sg_u32 sg_spinlock;
+
+void sg_spinlock_lock_contended(volatile sg_spinlock* p_lock);
+
+static inline sg_u8 sg_spinlock_try_lock(volatile sg_spinlock* p_lock)
+{
+    return sg_atomic_load_u32(p_lock) == 0 && sg_atomic_exchange_u32(p_lock, 1) == 0;
+}
+
+static inline void sg_spinlock_lock(volatile sg_spinlock* p_lock)
+{
+    if (!sg_spinlock_try_lock(p_lock))
+        sg_spinlock_lock_contended(p_lock);
+}
+
+static inline void sg_spinlock_unlock(volatile sg_spinlock* p_lock)
+{
+    sg_atomic_store_u32(p_lock, 0);
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "sg_types.h"
+#include "sg_hash_table.h"
+
+typedef struct sg_allocator sg_allocator;
+
+// Insert only open addressing map from sg_u32 keys, safe to emplace and find from any number of threads.
+// Slots are claimed with a CAS on the key, SG_HASH_TABLE_KEY_NULL marks an empty slot so it is not a valid key.
+// Capacity is fixed at creation, once every slot is claimed emplace of a new key returns NULL.
+// Values start zeroed and threads emplacing the same key share its slot, update them with sg_atomic operations.
+typedef struct sg_atomic_hash_table
+{
+    sg_allocator* p_allocator;
+    sg_u32* _keys;
+    sg_u8* _data;
+    sg_u32 _capacity;
+    sg_u32 _size;
+    sg_u32 _stride;
+
+} sg_atomic_hash_table;
+
+sg_atomic_hash_table sg_atomic_hash_table_create(sg_u32 capacity, sg_u32 stride, sg_allocator* p_allocator);
+
+void sg_atomic_hash_table_destroy(sg_atomic_hash_table* p_table);
+
+// Not synchronized with in flight emplaces
+void sg_atomic_hash_table_clear(sg_atomic_hash_table* p_table);
+
+sg_u32 sg_atomic_hash_table_size(sg_atomic_hash_table* p_table);
+
+sg_u32 sg_atomic_hash_table_capacity(sg_atomic_hash_table* p_table);
+
+sg_u8 sg_atomic_hash_table_find(sg_atomic_hash_table* p_table, sg_u32 key);
+
+sg_u8 sg_atomic_hash_table_find_index(sg_atomic_hash_table* p_table, sg_u32 key, sg_u32* p_idx);
+
+sg_u8 sg_atomic_hash_table_find_value(sg_atomic_hash_table* p_table, sg_u32 key, void** pp_value);
+
+// Returns the value of key, claiming a slot for it when absent, or NULL when the table is full
+void* sg_atomic_hash_table_emplace(sg_atomic_hash_table* p_table, sg_u32 key);
+
+void* sg_atomic_hash_table_value(sg_atomic_hash_table* p_table, sg_u32 idx);
+
+sg_u32 sg_atomic_hash_table_key(sg_atomic_hash_table* p_table, sg_u32 idx);
+
+#define SG_ATOMIC_HASH_TABLE_DEFINE_TYPE_EXT(hash_table_type, element_type)\
+typedef sg_atomic_hash_table hash_table_type;\
+inline hash_table_type hash_table_type##_create(sg_u32 capacity, sg_allocator* p_allocator) { return sg_atomic_hash_table_create(capacity, sizeof(element_type), p_allocator); }\
+inline void hash_table_type##_destroy(hash_table_type* p_table) { sg_atomic_hash_table_destroy(p_table); }\
+inline sg_u8 hash_table_type##_find(hash_table_type* p_table, sg_u32 key) { return sg_atomic_hash_table_find(p_table, key); }\
+inline sg_u8 hash_table_type##_find_value(hash_table_type* p_table, sg_u32 key, element_type** pp_element) { return sg_atomic_hash_table_find_value(p_table, key, (void**)pp_element); }\
+inline element_type* hash_table_type##_emplace(hash_table_type* p_table, sg_u32 key) { return (element_type*)sg_atomic_hash_table_emplace(p_table, key); }
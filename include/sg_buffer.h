@@ -1,5 +1,6 @@
 #pragma once
 #include "sg_types.h"
+#include "sg_virtual_memory.h"
 
 typedef struct sg_allocator sg_allocator;
 
@@ -8,13 +9,37 @@ typedef struct sg_buffer
     sg_allocator* allocator;
     sg_u8* allocation;
     sg_u64 size;
+    sg_u64 alignment;
+    sg_u64 reserved;
+    sg_u8 mapped;
 } sg_buffer;
 
 sg_buffer sg_buffer_create(sg_u64 size, sg_allocator* p_allocator);
 
+// The allocation starts on a multiple of alignment, a power of two, and keeps it when resized
+sg_buffer sg_buffer_create_aligned(sg_u64 size, sg_u64 alignment, sg_allocator* p_allocator);
+
+// Reserves reserve_size bytes of address space and commits pages as the buffer grows, the allocation never
+// moves and resizing past reserve_size fails. Size is rounded up to whole pages, so it can pass reserved.
+sg_buffer sg_buffer_create_reserved(sg_u64 size, sg_u64 reserve_size);
+
+// Maps the whole file at path, read only or with private copy on write pages, advice is one of
+// SG_VIRTUAL_MEMORY_ADVICE_*. Mapped buffers keep the file size and can not be resized.
+// The allocation is NULL when the file can not be mapped or is empty.
+sg_buffer sg_buffer_create_mapped(const char* path, sg_u8 copy_on_write, sg_u32 advice);
+
+// Updates the access pattern hint of a mapped or reserved buffer
+void sg_buffer_advise(sg_buffer* p_buffer, sg_u32 advice);
+
 void sg_buffer_destroy(sg_buffer* p_buffer);
 
-void sg_buffer_resize(sg_buffer* p_buffer, sg_u64 size);
+// Only ever grows the buffer, see sg_buffer_shrink for giving memory back. Returns 0 when the buffer can not
+// hold size bytes, it keeps what it had committed.
+sg_u8 sg_buffer_resize(sg_buffer* p_buffer, sg_u64 size);
+
+// Returns memory past size to its source. Heap buffers are reallocated and freed at 0, reserved buffers
+// decommit whole pages and keep the reservation, mapped buffers are left as they are.
+void sg_buffer_shrink(sg_buffer* p_buffer, sg_u64 size);
 
-void* sg_buffer_data(sg_buffer* p_buffer, sg_u32 offset);
+void* sg_buffer_data(sg_buffer* p_buffer, sg_u64 offset);
 
@@ -0,0 +1,65 @@
+#pragma once
+#include "sg_types.h"
+#include "sg_atomic.h"
+#include "sg_hash_table.h"
+
+#define SG_CONCURRENT_HASH_TABLE_CACHE_LINE 64U
+
+typedef struct sg_allocator sg_allocator;
+
+// Each shard is a plain sg_hash_table behind its own spinlock, padded so neighbouring locks do not share a line.
+typedef struct sg_concurrent_hash_table_shard
+{
+    sg_hash_table _table;
+    sg_spinlock _lock;
+    sg_u8 _pad[SG_CONCURRENT_HASH_TABLE_CACHE_LINE - sizeof(sg_spinlock)];
+} sg_concurrent_hash_table_shard;
+
+// Keys are split over a power of two number of shards by the high bits of the table hash.
+// Values are copied in and out under the shard lock since pointers into a shard move when it grows.
+typedef struct sg_concurrent_hash_table
+{
+    sg_allocator* p_allocator;
+    sg_concurrent_hash_table_shard* _shards;
+    sg_u32 _shard_count;
+    sg_u32 _shard_bits;
+    sg_u32 _frozen;
+} sg_concurrent_hash_table;
+
+sg_concurrent_hash_table sg_concurrent_hash_table_create(sg_u32 shard_count, sg_u32 capacity, sg_u32 stride, sg_f32 load_factor, sg_allocator* p_allocator);
+
+sg_concurrent_hash_table sg_concurrent_hash_table_create_ext(sg_u32 shard_count, sg_u32 capacity, sg_u32 key_stride, sg_u32 stride, sg_f32 load_factor, sg_hash_table_hash_fn p_hash, sg_hash_table_equal_fn p_equal, sg_allocator* p_allocator);
+
+void sg_concurrent_hash_table_destroy(sg_concurrent_hash_table* p_table);
+
+sg_u32 sg_concurrent_hash_table_size(sg_concurrent_hash_table* p_table);
+
+sg_u8 sg_concurrent_hash_table_find(sg_concurrent_hash_table* p_table, sg_u32 key);
+
+sg_u8 sg_concurrent_hash_table_find_value(sg_concurrent_hash_table* p_table, sg_u32 key, void* p_value);
+
+sg_u8 sg_concurrent_hash_table_insert(sg_concurrent_hash_table* p_table, sg_u32 key, void* p_value);
+
+sg_u8 sg_concurrent_hash_table_remove(sg_concurrent_hash_table* p_table, sg_u32 key);
+
+sg_u8 sg_concurrent_hash_table_find_key(sg_concurrent_hash_table* p_table, const void* p_key);
+
+// Copies the value out when found, p_value may be NULL
+sg_u8 sg_concurrent_hash_table_find_key_value(sg_concurrent_hash_table* p_table, const void* p_key, void* p_value);
+
+// Inserts when the key is absent, returns 1 if this call inserted it
+sg_u8 sg_concurrent_hash_table_insert_key(sg_concurrent_hash_table* p_table, const void* p_key, void* p_value);
+
+// Returns 1 if this call removed the key
+sg_u8 sg_concurrent_hash_table_remove_key(sg_concurrent_hash_table* p_table, const void* p_key);
+
+// Locks the shard owning p_key and returns its table for compound updates, pair with unlock.
+sg_hash_table* sg_concurrent_hash_table_lock(sg_concurrent_hash_table* p_table, const void* p_key);
+
+void sg_concurrent_hash_table_unlock(sg_concurrent_hash_table* p_table, sg_hash_table* p_shard);
+
+// Between freeze and thaw lookups skip the shard locks and writes are not allowed.
+// Callers order the phase change against other threads, for example with a join or barrier.
+void sg_concurrent_hash_table_freeze(sg_concurrent_hash_table* p_table);
+
+void sg_concurrent_hash_table_thaw(sg_concurrent_hash_table* p_table);
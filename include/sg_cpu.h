@@ -0,0 +1,88 @@
+#pragma once
+#include "sg_types.h"
+
+// Instruction set levels, each implies the ones below it
+#define SG_CPU_LEVEL_SCALAR 0U
+#define SG_CPU_LEVEL_SSE2 1U
+#define SG_CPU_LEVEL_AVX2 2U
+#define SG_CPU_LEVEL_AVX512 3U
+#define SG_CPU_LEVEL_COUNT 4U
+#define SG_CPU_LEVEL_NULL ~0U
+
+// Caps the level picked at startup, one of scalar, sse2, avx2, avx512 or the level number
+#define SG_CPU_LEVEL_ENV "SG_CPU_LEVEL"
+
+// Clears of at least this many bytes bypass the cache with streaming stores
+#define SG_CPU_STREAM_THRESHOLD (1024U * 1024U)
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SG_CPU_X86 1
+#else
+#define SG_CPU_X86 0
+#endif
+
+// Wider kernels are compiled per function so one build carries every level
+#if SG_CPU_X86 && (defined(__GNUC__) || defined(__clang__))
+#define SG_CPU_TARGET_SSE2 __attribute__((target("sse2")))
+#define SG_CPU_TARGET_AVX2 __attribute__((target("avx2")))
+#define SG_CPU_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+#else
+#define SG_CPU_TARGET_SSE2
+#define SG_CPU_TARGET_AVX2
+#define SG_CPU_TARGET_AVX512
+#endif
+
+typedef struct sg_cpu_features
+{
+    sg_u8 sse2;
+    sg_u8 sse41;
+    sg_u8 sse42;
+    sg_u8 popcnt;
+    sg_u8 avx;
+    sg_u8 avx2;
+    sg_u8 bmi1;
+    sg_u8 bmi2;
+    sg_u8 avx512f;
+    sg_u8 avx512bw;
+    // The highest level the CPU and the OS both support
+    sg_u32 level;
+} sg_cpu_features;
+
+// One entry per multiversioned kernel, a table is filled for every level at startup and the active one
+// is swapped in as a whole.
+typedef struct sg_cpu_dispatch
+{
+    sg_u32 level;
+    void (*p_memclear)(void* p_data, sg_u64 size);
+    sg_u32 (*p_slice_find)(const sg_u8* p_data, sg_u32 count, sg_u64 value, sg_u32 width);
+    sg_u32 (*p_slice_count)(const sg_u8* p_data, sg_u32 count, sg_u64 value, sg_u32 width);
+    void (*p_slice_min_max)(const sg_u8* p_data, sg_u32 count, sg_u32 width, sg_u64* p_min, sg_u64* p_max);
+    void (*p_slice_fill)(sg_u8* p_data, sg_u32 count, sg_u32 stride, const sg_u8* p_value);
+    void (*p_slice_gather)(const sg_u8* p_data, sg_u32 count, sg_u32 stride, sg_u32 offset, sg_u32 size, sg_u8* p_output);
+    sg_u8 (*p_slice_equal)(const sg_u8* p_data_a, const sg_u8* p_data_b, sg_u64 size);
+} sg_cpu_dispatch;
+
+// Runs cpuid once, later calls return the cached result
+sg_cpu_features sg_cpu_detect(void);
+
+// The active dispatch table, the first call detects features and applies SG_CPU_LEVEL_ENV
+const sg_cpu_dispatch* sg_cpu_dispatch_table(void);
+
+sg_u32 sg_cpu_level(void);
+
+// Switches every kernel to a level for testing and comparison, clamped to what the CPU supports.
+// Returns the level now in use.
+sg_u32 sg_cpu_set_level(sg_u32 level);
+
+const char* sg_cpu_level_name(sg_u32 level);
+
+// Accepts a level name or number, returns SG_CPU_LEVEL_NULL for anything else
+sg_u32 sg_cpu_level_parse(const char* p_name);
+
+static inline void sg_cpu_memclear(void* p_data, sg_u64 size)
+{
+    sg_cpu_dispatch_table()->p_memclear(p_data, size);
+}
+
+// Kernel modules set their entries of a table for a level
+void sg_slice_kernels_fill(sg_cpu_dispatch* p_dispatch, sg_u32 level);
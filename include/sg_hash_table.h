@@ -1,31 +1,73 @@
 #pragma once
 #include "sg_types.h"
 
+// Empty slots are tracked by the control bytes so every key is valid, KEY_NULL only fills vacated key storage.
 #define SG_HASH_TABLE_IDX_NULL ~0U
 #define SG_HASH_TABLE_KEY_NULL ~0U
 #define SG_HASH_TABLE_VAL_NULL 0U
 
+// Control bytes hold a 7 bit tag of the key hash for full slots and the high bit for empty ones.
+// Lookups compare a group of control bytes at once, the tail of the array mirrors the first group.
+#define SG_HASH_TABLE_GROUP_WIDTH 16U
+#define SG_HASH_TABLE_CTRL_EMPTY 0x80U
+#define SG_HASH_TABLE_CTRL_MOVED 0xFEU
+
+// Robin Hood probing keeps the distance of every entry from its start slot, empty slots store the high bit.
+// Inserts that would push an entry past the maximum distance grow the table instead.
+#define SG_HASH_TABLE_DIST_EMPTY 0x80U
+#define SG_HASH_TABLE_DIST_MAX 0x7FU
+
 typedef struct sg_allocator sg_allocator;
 
+// Keys of 4 or 8 bytes are hashed and compared inline, other sizes default to FNV-1a and memcmp.
+// Supplying either callback overrides the default for that operation.
+typedef sg_u32 (*sg_hash_table_hash_fn)(const void* p_key, sg_u32 key_stride);
+typedef sg_u8 (*sg_hash_table_equal_fn)(const void* p_key_a, const void* p_key_b, sg_u32 key_stride);
+
 typedef struct sg_hash_table
 {
     sg_allocator* p_allocator;
-    sg_u32* _keys;
+    sg_hash_table_hash_fn _hash;
+    sg_hash_table_equal_fn _equal;
+    sg_u8* _ctrl;
+    sg_u8* _dist;
+    sg_u8* _keys;
     sg_u8* _data;
+    sg_u8* _prev_ctrl;
+    sg_u8* _prev_dist;
+    sg_u8* _prev_keys;
+    sg_u8* _prev_data;
     sg_u32 _capacity;
+    sg_u32 _prev_capacity;
+    sg_u32 _migrate_idx;
+    sg_u32 _migrate_step;
     sg_u32 _size;
+    sg_u32 _key_stride;
     sg_u32 _stride;
-    sg_u32 _probe_length;
+    sg_u32 _hash_shift;
     sg_f32 _load_factor;
 
 } sg_hash_table;
 
 sg_hash_table sg_hash_table_create(sg_u32 capacity, sg_u32 stride, sg_f32 load_factor, sg_allocator* p_allocator);
 
+sg_hash_table sg_hash_table_create_ext(sg_u32 capacity, sg_u32 key_stride, sg_u32 stride, sg_f32 load_factor, sg_hash_table_hash_fn p_hash, sg_hash_table_equal_fn p_equal, sg_allocator* p_allocator);
+
 void sg_hash_table_destroy(sg_hash_table* p_table);
 
 void sg_hash_table_reserve(sg_hash_table* p_table, sg_u32 size);
 
+// Opt into incremental resizing. Growth keeps the previous arrays live and every insert, find and remove
+// moves migrate_step of their buckets across, lookups check both until the move is done. 0 turns it off.
+void sg_hash_table_set_incremental(sg_hash_table* p_table, sg_u32 migrate_step);
+
+// Moves up to bucket_count buckets of an in flight resize, returns 1 while any are left.
+sg_u8 sg_hash_table_migrate(sg_hash_table* p_table, sg_u32 bucket_count);
+
+// The hash that picks start slots, before any _hash_shift. Tables nested under an outer level that
+// already consumed the high bits of this hash (like shards) shift them out so slots stay uniform.
+sg_u32 sg_hash_table_hash(sg_hash_table* p_table, const void* p_key);
+
 sg_u32 sg_hash_table_size(sg_hash_table* p_table);
 
 sg_u32 sg_hash_table_capacity(sg_hash_table* p_table);
@@ -40,12 +82,39 @@ void* sg_hash_table_emplace(sg_hash_table* p_table, sg_u32 key);
 
 void sg_hash_table_insert(sg_hash_table* p_table, sg_u32 key, void* p_value);
 
+// Inserts count packed keys and values after sizing the table once, probes are prefetched ahead of use.
+void sg_hash_table_insert_batch(sg_hash_table* p_table, const void* p_keys, const void* p_values, sg_u32 count);
+
+// Looks up count packed keys, pp_values receives the value or NULL for each key. Returns the number found.
+sg_u32 sg_hash_table_find_batch(sg_hash_table* p_table, const void* p_keys, sg_u32 count, void** pp_values);
+
 void sg_hash_table_remove_at_index(sg_hash_table* p_table, sg_u32 idx);
 
 void sg_hash_table_remove(sg_hash_table* p_table, sg_u32 key);
 
 void sg_hash_table_clear(sg_hash_table* p_table);
 
+sg_u8 sg_hash_table_find_key(sg_hash_table* p_table, const void* p_key);
+
+sg_u8 sg_hash_table_find_key_index(sg_hash_table* p_table, const void* p_key, sg_u32* p_idx);
+
+sg_u8 sg_hash_table_find_key_value(sg_hash_table* p_table, const void* p_key, void** pp_value);
+
+void* sg_hash_table_emplace_key(sg_hash_table* p_table, const void* p_key);
+
+void sg_hash_table_insert_key(sg_hash_table* p_table, const void* p_key, void* p_value);
+
+void sg_hash_table_remove_key(sg_hash_table* p_table, const void* p_key);
+
+void* sg_hash_table_key(sg_hash_table* p_table, sg_u32 idx);
+
+// Writes the slot arrays and parameters as a flat snapshot, see sg_snapshot.h. Returns 1 on success.
+sg_u8 sg_hash_table_save(sg_hash_table* p_table, const char* path);
+
+// Reads a snapshot back into a new table without rehashing, p_table is only written on success. The hash and
+// equal callbacks have to match the ones the table was saved with.
+sg_u8 sg_hash_table_load(sg_hash_table* p_table, const char* path, sg_hash_table_hash_fn p_hash, sg_hash_table_equal_fn p_equal, sg_allocator* p_allocator);
+
 #define SG_HASH_TABLE_DEFINE_TYPE_EXT(hash_table_type, element_type)\
 typedef sg_hash_table hash_table_type;\
 inline hash_table_type hash_table_type##_create(sg_u32 size, sg_f32 load_factor, sg_allocator* p_allocator) { return sg_hash_table_create(size, sizeof(element_type), load_factor, p_allocator); }\
@@ -55,4 +124,19 @@ inline sg_u8 hash_table_type##_find_index(hash_table_type* p_table, sg_u32 key,
 inline sg_u8 hash_table_type##_find_value(hash_table_type* p_table, sg_u32 key, element_type** pp_element) { return sg_hash_table_find_value(p_table, key, (void**)pp_element); }\
 inline void hash_table_type##_insert(hash_table_type* p_table, sg_u32 key, element_type element) { sg_hash_table_insert(p_table, key, &element); }\
 inline element_type* hash_table_type##_emplace(hash_table_type* p_table, sg_u32 key) { return (element_type*)sg_hash_table_emplace(p_table, key); }\
-inline void hash_table_type##_remove(hash_table_type* p_table, sg_u32 key) { sg_hash_table_remove(p_table, key); }
\ No newline at end of file
+inline void hash_table_type##_remove(hash_table_type* p_table, sg_u32 key) { sg_hash_table_remove(p_table, key); }\
+inline void hash_table_type##_insert_batch(hash_table_type* p_table, const sg_u32* p_keys, const element_type* p_elements, sg_u32 count) { sg_hash_table_insert_batch(p_table, p_keys, p_elements, count); }\
+inline sg_u32 hash_table_type##_find_batch(hash_table_type* p_table, const sg_u32* p_keys, sg_u32 count, element_type** pp_elements) { return sg_hash_table_find_batch(p_table, p_keys, count, (void**)pp_elements); }
+
+#define SG_HASH_TABLE_DEFINE_KEY_TYPE_EXT(hash_table_type, key_type, element_type)\
+typedef sg_hash_table hash_table_type;\
+inline hash_table_type hash_table_type##_create(sg_u32 size, sg_f32 load_factor, sg_allocator* p_allocator) { return sg_hash_table_create_ext(size, sizeof(key_type), sizeof(element_type), load_factor, NULL, NULL, p_allocator); }\
+inline void hash_table_type##_destroy(hash_table_type* p_table) { sg_hash_table_destroy(p_table); }\
+inline sg_u8 hash_table_type##_find(hash_table_type* p_table, key_type key) { return sg_hash_table_find_key(p_table, &key); }\
+inline sg_u8 hash_table_type##_find_index(hash_table_type* p_table, key_type key, sg_u32* p_idx) { return sg_hash_table_find_key_index(p_table, &key, p_idx); }\
+inline sg_u8 hash_table_type##_find_value(hash_table_type* p_table, key_type key, element_type** pp_element) { return sg_hash_table_find_key_value(p_table, &key, (void**)pp_element); }\
+inline void hash_table_type##_insert(hash_table_type* p_table, key_type key, element_type element) { sg_hash_table_insert_key(p_table, &key, &element); }\
+inline element_type* hash_table_type##_emplace(hash_table_type* p_table, key_type key) { return (element_type*)sg_hash_table_emplace_key(p_table, &key); }\
+inline void hash_table_type##_remove(hash_table_type* p_table, key_type key) { sg_hash_table_remove_key(p_table, &key); }\
+inline void hash_table_type##_insert_batch(hash_table_type* p_table, const key_type* p_keys, const element_type* p_elements, sg_u32 count) { sg_hash_table_insert_batch(p_table, p_keys, p_elements, count); }\
+inline sg_u32 hash_table_type##_find_batch(hash_table_type* p_table, const key_type* p_keys, sg_u32 count, element_type** pp_elements) { return sg_hash_table_find_batch(p_table, p_keys, count, (void**)pp_elements); }
\ No newline at end of file
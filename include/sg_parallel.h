@@ -0,0 +1,87 @@
+#pragma once
+#include "sg_types.h"
+#include "sg_atomic.h"
+#include "sg_slice.h"
+#include "sg_thread.h"
+
+#define SG_PARALLEL_CACHE_LINE 64U
+#define SG_PARALLEL_DEQUE_CAPACITY 64U
+
+// Bytes of elements the auto grain aims to hand a worker at a time
+#define SG_PARALLEL_GRAIN_BYTES (32U * 1024U)
+
+typedef struct sg_allocator sg_allocator;
+
+// Called with a run of consecutive elements, offset is the index of the first one in the whole slice
+typedef void (*sg_parallel_for_each_fn)(sg_slice* p_chunk, sg_u32 offset, void* p_user_data);
+
+// p_output views the same elements of the output slice as p_input does of the input slice
+typedef void (*sg_parallel_transform_fn)(sg_slice* p_input, sg_slice* p_output, sg_u32 offset, void* p_user_data);
+
+// Folds the chunk into p_accumulator
+typedef void (*sg_parallel_reduce_fn)(sg_slice* p_chunk, void* p_accumulator, void* p_user_data);
+
+// Folds p_other into p_accumulator, must be associative
+typedef void (*sg_parallel_combine_fn)(void* p_accumulator, const void* p_other, void* p_user_data);
+
+typedef struct sg_parallel_range
+{
+    sg_u32 begin;
+    sg_u32 end;
+} sg_parallel_range;
+
+// The owner pushes and pops at the bottom, thieves take the oldest and largest ranges from the top
+typedef struct sg_parallel_deque
+{
+    sg_spinlock _lock;
+    sg_u32 _top;
+    sg_u32 _bottom;
+    sg_u8 _pad[SG_PARALLEL_CACHE_LINE - sizeof(sg_spinlock) - 2 * sizeof(sg_u32)];
+    sg_parallel_range _ranges[SG_PARALLEL_DEQUE_CAPACITY];
+} sg_parallel_deque;
+
+typedef struct sg_parallel_pool sg_parallel_pool;
+
+typedef struct sg_parallel_worker
+{
+    sg_parallel_pool* p_pool;
+    sg_u32 _index;
+} sg_parallel_worker;
+
+// A range starts on the calling thread's deque and is split in halves down to the grain as it is worked on,
+// idle workers steal the upper halves. The calling thread takes part as worker 0 and every call blocks until
+// the whole slice is done. Calls from several threads are run one after another, callbacks must not call back
+// into the same pool.
+struct sg_parallel_pool
+{
+    sg_allocator* p_allocator;
+    sg_thread* _threads;
+    sg_parallel_worker* _workers;
+    sg_parallel_deque* _deques;
+    sg_u32 _worker_count;
+    sg_mutex _mutex;
+    sg_condition _condition;
+    void* volatile _job;
+    sg_u32 _generation;
+    sg_u32 _active;
+    sg_u32 _stop;
+    sg_spinlock _submit;
+};
+
+// Worker count includes the calling thread, 0 uses every hardware thread. Threads start on first use
+// and keep a pointer to the pool, it must not move after that.
+sg_parallel_pool sg_parallel_pool_create(sg_u32 worker_count, sg_allocator* p_allocator);
+
+void sg_parallel_pool_destroy(sg_parallel_pool* p_pool);
+
+// Elements per chunk aiming at SG_PARALLEL_GRAIN_BYTES while leaving several chunks per worker to balance
+sg_u32 sg_parallel_grain(sg_slice* p_slice, sg_u32 worker_count);
+
+// A grain of 0 picks one with sg_parallel_grain. A NULL pool runs on the calling thread.
+void sg_parallel_for_each(sg_parallel_pool* p_pool, sg_slice* p_slice, sg_u32 grain, sg_parallel_for_each_fn p_fn, void* p_user_data);
+
+void sg_parallel_transform(sg_parallel_pool* p_pool, sg_slice* p_input, sg_slice* p_output, sg_u32 grain, sg_parallel_transform_fn p_fn, void* p_user_data);
+
+// p_result holds the identity on entry and the reduction on return. Each worker folds into its own copy of the
+// identity and the copies are combined at the end, so the grouping of floating point sums varies between runs.
+void sg_parallel_reduce(sg_parallel_pool* p_pool, sg_slice* p_slice, sg_u32 grain, void* p_result, sg_u32 result_size, sg_parallel_reduce_fn p_reduce, sg_parallel_combine_fn p_combine, void* p_user_data);
@@ -0,0 +1,60 @@
+#pragma once
+#include "sg_types.h"
+
+typedef struct sg_allocator sg_allocator;
+
+// Size classes are powers of two from the minimum block size, larger requests go to the parent allocator.
+// Blocks are 16 byte aligned and carry their requested size in the header in front of them.
+#define SG_POOL_ALLOCATOR_CLASS_COUNT 8U
+#define SG_POOL_ALLOCATOR_MIN_BLOCK 16U
+#define SG_POOL_ALLOCATOR_HEADER 16U
+#define SG_POOL_ALLOCATOR_SLAB_SIZE (64U * 1024U)
+
+// Larger requests also link into a list in front of their header so destroy can release them
+#define SG_POOL_ALLOCATOR_LARGE_HEADER 16U
+
+typedef struct sg_pool_slab
+{
+    struct sg_pool_slab* _next;
+} sg_pool_slab;
+
+typedef struct sg_pool_large
+{
+    struct sg_pool_large* _prev;
+    struct sg_pool_large* _next;
+} sg_pool_large;
+
+// Free blocks link through their first bytes, the most recently freed block is handed out first.
+// Slabs are carved as blocks are needed rather than threaded onto the free list up front.
+typedef struct sg_pool_class
+{
+    void* _free;
+    sg_u8* _cursor;
+    sg_u8* _end;
+} sg_pool_class;
+
+typedef struct sg_pool_allocator
+{
+    sg_allocator* p_parent;
+    sg_pool_slab* _slabs;
+    sg_pool_large* _large;
+    sg_pool_class _classes[SG_POOL_ALLOCATOR_CLASS_COUNT];
+    sg_u64 _slab_size;
+} sg_pool_allocator;
+
+sg_pool_allocator sg_pool_allocator_create(sg_u64 slab_size, sg_allocator* p_parent);
+
+// Returns every slab and larger block to the parent, blocks still in use are released with them
+void sg_pool_allocator_destroy(sg_pool_allocator* p_pool);
+
+// An sg_allocator that allocates from the pool, the pool must stay at the same address while it is in use.
+sg_allocator sg_pool_allocator_allocator(sg_pool_allocator* p_pool);
+
+void* sg_pool_allocator_allocate(sg_pool_allocator* p_pool, sg_u64 size);
+
+void sg_pool_allocator_free(sg_pool_allocator* p_pool, void* p_allocation);
+
+void* sg_pool_allocator_realloc(sg_pool_allocator* p_pool, void* p_allocation, sg_u64 size);
+
+// Largest request served from a size class
+sg_u64 sg_pool_allocator_max_block(void);
@@ -17,6 +17,27 @@ void* sg_slice_data(sg_slice* p_slice, sg_u32 index);
 
 sg_slice sg_slice_to_slice(sg_slice* p_slice, sg_u32 offset, sg_u32 count);
 
+// Scan kernels over packed slices of unsigned 1, 2, 4 or 8 byte elements, the element width is the stride.
+// Each call runs through the sg_cpu dispatch table, see sg_cpu_set_level.
+#define SG_SLICE_IDX_NULL ~0U
+
+// Index of the first element equal to value or SG_SLICE_IDX_NULL
+sg_u32 sg_slice_find(sg_slice* p_slice, sg_u64 value);
+
+sg_u32 sg_slice_count(sg_slice* p_slice, sg_u64 value);
+
+// Returns 0 for an empty slice
+sg_u8 sg_slice_min_max(sg_slice* p_slice, sg_u64* p_min, sg_u64* p_max);
+
+// Copies the stride bytes at p_value into every element, any stride
+void sg_slice_fill(sg_slice* p_slice, const void* p_value);
+
+// Packs the size bytes at offset within every element into p_output, any stride
+void sg_slice_gather(sg_slice* p_slice, sg_u32 offset, sg_u32 size, void* p_output);
+
+// Same count, stride and bytes
+sg_u8 sg_slice_equal(sg_slice* p_slice_a, sg_slice* p_slice_b);
+
 #define SG_SLICE_DEFINE_TYPE_EXT(slice_type, element_type)\
 typedef sg_slice slice_type;\
 inline slice_type slice_type##_make(element_type* p_data, sg_u32 offset, sg_u32 count) { return sg_slice_make(p_data, offset, count, sizeof(element_type)); }\
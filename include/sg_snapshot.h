@@ -0,0 +1,45 @@
+#pragma once
+#include "sg_types.h"
+#include <stdio.h>
+
+// Flat snapshot files are a fixed header followed by the container arrays exactly as they sit in memory.
+// Files are native endian, a byte swapped magic reads as a mismatch. The checksum covers the header, with the
+// checksum field zeroed, followed by the payload.
+#define SG_SNAPSHOT_MAGIC 0x4e534753U
+#define SG_SNAPSHOT_VERSION 2U
+#define SG_SNAPSHOT_KIND_VECTOR 1U
+#define SG_SNAPSHOT_KIND_HASH_TABLE 2U
+#define SG_SNAPSHOT_PARAMS 8U
+
+typedef struct sg_snapshot_header
+{
+    sg_u32 magic;
+    sg_u32 version;
+    sg_u32 kind;
+    sg_u32 header_size;
+    sg_u64 payload_size;
+    sg_u64 checksum;
+    sg_u32 params[SG_SNAPSHOT_PARAMS];
+} sg_snapshot_header;
+
+typedef struct sg_snapshot_reader
+{
+    FILE* _file;
+    sg_u64 _checksum;
+    sg_u64 _remaining;
+} sg_snapshot_reader;
+
+// Chains the checksum of the next part of a payload onto checksum, start from 0
+sg_u64 sg_snapshot_checksum(sg_u64 checksum, const void* p_data, sg_u64 size);
+
+// Fills in the common header fields and writes it followed by the parts, returns 1 on success
+sg_u8 sg_snapshot_save(const char* path, sg_snapshot_header* p_header, const void* const* pp_parts, const sg_u64* p_sizes, sg_u32 count);
+
+// Opens the file and reads a header of the expected kind and version, returns 0 and leaves nothing open otherwise
+sg_u8 sg_snapshot_open(sg_snapshot_reader* p_reader, const char* path, sg_u32 kind, sg_snapshot_header* p_header);
+
+// Reads the next part straight into p_data, parts are read back with the same sizes they were saved with
+sg_u8 sg_snapshot_read(sg_snapshot_reader* p_reader, void* p_data, sg_u64 size);
+
+// Closes the file, returns 1 when the whole payload was read and its checksum matches the header
+sg_u8 sg_snapshot_close(sg_snapshot_reader* p_reader, const sg_snapshot_header* p_header);
@@ -0,0 +1,93 @@
+#pragma once
+#include "sg_types.h"
+#include "sg_slice.h"
+
+#define SG_SOA_VECTOR_MAX_COLUMNS 8U
+#define SG_SOA_VECTOR_COLUMN_ALIGNMENT 64U
+
+// Returned by push and emplace when the vector can not grow
+#define SG_SOA_VECTOR_IDX_NULL ~0U
+
+typedef struct sg_allocator sg_allocator;
+
+// Structure of arrays, each field lives in its own column so a scan over one field streams contiguous memory.
+// All columns share one allocation, each starting on a cache line, and grow together.
+typedef struct sg_soa_vector
+{
+    sg_allocator* p_allocator;
+    sg_u8* _allocation;
+    sg_u8* _columns[SG_SOA_VECTOR_MAX_COLUMNS];
+    sg_u32 _strides[SG_SOA_VECTOR_MAX_COLUMNS];
+    sg_u32 _column_count;
+    sg_u32 _capacity;
+    sg_u32 _size;
+} sg_soa_vector;
+
+sg_soa_vector sg_soa_vector_create(sg_u32 size, const sg_u32* p_strides, sg_u32 column_count, sg_allocator* p_allocator);
+
+void sg_soa_vector_destroy(sg_soa_vector* p_vector);
+
+// Returns 0 when the capacity can not reach size
+sg_u8 sg_soa_vector_reserve(sg_soa_vector* p_vector, sg_u32 size);
+
+// New elements are zeroed. Returns 0 and keeps the size when the vector can not hold size elements
+sg_u8 sg_soa_vector_resize(sg_soa_vector* p_vector, sg_u32 size);
+
+// Appends a zeroed element and returns its index or SG_SOA_VECTOR_IDX_NULL when the vector can not grow
+sg_u32 sg_soa_vector_emplace(sg_soa_vector* p_vector);
+
+// Copies one field per column from p_fields, returns the index of the new element or
+// SG_SOA_VECTOR_IDX_NULL when the vector can not grow
+sg_u32 sg_soa_vector_push(sg_soa_vector* p_vector, const void* const* p_fields);
+
+void sg_soa_vector_erase(sg_soa_vector* p_vector, sg_u32 index);
+
+// Moves the last element into index, constant time but the order is not kept
+void sg_soa_vector_erase_swap(sg_soa_vector* p_vector, sg_u32 index);
+
+sg_u32 sg_soa_vector_size(sg_soa_vector* p_vector);
+
+void* sg_soa_vector_data(sg_soa_vector* p_vector, sg_u32 column, sg_u32 index);
+
+// Views every element of one column, valid until the vector grows
+sg_slice sg_soa_vector_column(sg_soa_vector* p_vector, sg_u32 column);
+
+#define SG_SOA_VECTOR_DEFINE_COLUMN_EXT(vector_type, column, element_type, name)\
+inline element_type* vector_type##_##name(vector_type * p_vector, sg_u32 index) { return (element_type*)sg_soa_vector_data(p_vector, column, index); }\
+inline sg_slice vector_type##_##name##_column(vector_type * p_vector) { return sg_soa_vector_column(p_vector, column); }
+
+#define SG_SOA_VECTOR_DEFINE_COMMON_EXT(vector_type)\
+inline void vector_type##_destroy(vector_type * p_vector) { sg_soa_vector_destroy(p_vector); }\
+inline sg_u8 vector_type##_reserve(vector_type * p_vector, sg_u32 size) { return sg_soa_vector_reserve(p_vector, size); }\
+inline sg_u8 vector_type##_resize(vector_type * p_vector, sg_u32 size) { return sg_soa_vector_resize(p_vector, size); }\
+inline sg_u32 vector_type##_emplace(vector_type * p_vector) { return sg_soa_vector_emplace(p_vector); }\
+inline void vector_type##_erase(vector_type * p_vector, sg_u32 index) { sg_soa_vector_erase(p_vector, index); }\
+inline void vector_type##_erase_swap(vector_type * p_vector, sg_u32 index) { sg_soa_vector_erase_swap(p_vector, index); }\
+inline sg_u32 vector_type##_size(vector_type * p_vector) { return sg_soa_vector_size(p_vector); }
+
+#define SG_SOA_VECTOR_DEFINE_TYPE_EXT2(vector_type, type0, name0, type1, name1)\
+typedef sg_soa_vector vector_type;\
+inline vector_type vector_type##_create(sg_u32 size, sg_allocator* p_allocator) { sg_u32 strides[2] = { sizeof(type0), sizeof(type1) }; return sg_soa_vector_create(size, strides, 2, p_allocator); }\
+inline sg_u32 vector_type##_push(vector_type * p_vector, type0 name0, type1 name1) { const void* p_fields[2] = { &name0, &name1 }; return sg_soa_vector_push(p_vector, p_fields); }\
+SG_SOA_VECTOR_DEFINE_COMMON_EXT(vector_type)\
+SG_SOA_VECTOR_DEFINE_COLUMN_EXT(vector_type, 0, type0, name0)\
+SG_SOA_VECTOR_DEFINE_COLUMN_EXT(vector_type, 1, type1, name1)
+
+#define SG_SOA_VECTOR_DEFINE_TYPE_EXT3(vector_type, type0, name0, type1, name1, type2, name2)\
+typedef sg_soa_vector vector_type;\
+inline vector_type vector_type##_create(sg_u32 size, sg_allocator* p_allocator) { sg_u32 strides[3] = { sizeof(type0), sizeof(type1), sizeof(type2) }; return sg_soa_vector_create(size, strides, 3, p_allocator); }\
+inline sg_u32 vector_type##_push(vector_type * p_vector, type0 name0, type1 name1, type2 name2) { const void* p_fields[3] = { &name0, &name1, &name2 }; return sg_soa_vector_push(p_vector, p_fields); }\
+SG_SOA_VECTOR_DEFINE_COMMON_EXT(vector_type)\
+SG_SOA_VECTOR_DEFINE_COLUMN_EXT(vector_type, 0, type0, name0)\
+SG_SOA_VECTOR_DEFINE_COLUMN_EXT(vector_type, 1, type1, name1)\
+SG_SOA_VECTOR_DEFINE_COLUMN_EXT(vector_type, 2, type2, name2)
+
+#define SG_SOA_VECTOR_DEFINE_TYPE_EXT4(vector_type, type0, name0, type1, name1, type2, name2, type3, name3)\
+typedef sg_soa_vector vector_type;\
+inline vector_type vector_type##_create(sg_u32 size, sg_allocator* p_allocator) { sg_u32 strides[4] = { sizeof(type0), sizeof(type1), sizeof(type2), sizeof(type3) }; return sg_soa_vector_create(size, strides, 4, p_allocator); }\
+inline sg_u32 vector_type##_push(vector_type * p_vector, type0 name0, type1 name1, type2 name2, type3 name3) { const void* p_fields[4] = { &name0, &name1, &name2, &name3 }; return sg_soa_vector_push(p_vector, p_fields); }\
+SG_SOA_VECTOR_DEFINE_COMMON_EXT(vector_type)\
+SG_SOA_VECTOR_DEFINE_COLUMN_EXT(vector_type, 0, type0, name0)\
+SG_SOA_VECTOR_DEFINE_COLUMN_EXT(vector_type, 1, type1, name1)\
+SG_SOA_VECTOR_DEFINE_COLUMN_EXT(vector_type, 2, type2, name2)\
+SG_SOA_VECTOR_DEFINE_COLUMN_EXT(vector_type, 3, type3, name3)
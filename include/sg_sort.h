@@ -0,0 +1,23 @@
+#pragma once
+#include "sg_types.h"
+#include "sg_slice.h"
+
+typedef struct sg_allocator sg_allocator;
+typedef struct sg_parallel_pool sg_parallel_pool;
+
+#define SG_SORT_RADIX_BITS 8U
+#define SG_SORT_RADIX_BUCKETS (1U << SG_SORT_RADIX_BITS)
+
+// Elements handled per block of a pass, smaller sorts use fewer workers
+#define SG_SORT_MIN_BLOCK 16384U
+
+// Stable least significant digit radix sort of whole elements by an unsigned key of key_size bytes, 4 or 8,
+// at key_offset within each element. Any stride works so the rest of the element rides along as payload.
+// Each pass histograms and scatters blocks of the slice on the pool, a NULL pool sorts on the calling thread.
+// Passes where every key has the same digit are skipped. Uses a scratch copy of the slice from p_allocator.
+void sg_sort_radix(sg_parallel_pool* p_pool, sg_slice* p_slice, sg_u32 key_offset, sg_u32 key_size, sg_allocator* p_allocator);
+
+// Keys at the start of each element
+void sg_sort_radix_u32(sg_parallel_pool* p_pool, sg_slice* p_slice, sg_allocator* p_allocator);
+
+void sg_sort_radix_u64(sg_parallel_pool* p_pool, sg_slice* p_slice, sg_allocator* p_allocator);
@@ -0,0 +1,57 @@
+#pragma once
+#include "sg_types.h"
+#include "sg_slice.h"
+#include "sg_thread.h"
+#include <stdio.h>
+
+typedef struct sg_allocator sg_allocator;
+typedef struct sg_vector sg_vector;
+
+#define SG_STREAM_CHUNK_SIZE (4U * 1024U * 1024U)
+#define SG_STREAM_CHUNK_COUNT 2U
+
+// Chunks are handed back and forth between the caller and a background I/O thread. While the caller works
+// on one chunk the thread reads or writes the other, memory stays at two chunks whatever the file size.
+typedef struct sg_stream
+{
+    sg_allocator* p_allocator;
+    FILE* _file;
+    sg_u8* _chunks[SG_STREAM_CHUNK_COUNT];
+    sg_u64 _sizes[SG_STREAM_CHUNK_COUNT];
+    sg_u8 _full[SG_STREAM_CHUNK_COUNT];
+    sg_u64 _chunk_size;
+    sg_u32 _stride;
+    sg_u32 _current;
+    sg_u8 _held;
+    sg_u8 _stop;
+    sg_u8 _error;
+    sg_mutex _mutex;
+    sg_condition _condition;
+    sg_thread _thread;
+} sg_stream;
+
+typedef sg_stream sg_stream_reader;
+typedef sg_stream sg_stream_writer;
+
+// Chunks hold whole elements of stride bytes, chunk_size 0 picks SG_STREAM_CHUNK_SIZE.
+// Returns 0 when the file can not be opened or the chunks or thread can not be set up, nothing is left open.
+sg_u8 sg_stream_reader_open(sg_stream_reader* p_reader, const char* path, sg_u32 stride, sg_u64 chunk_size, sg_allocator* p_allocator);
+
+// Hands out the next chunk as a slice, valid until the following call. Returns 0 at the end of the file,
+// a trailing partial element is dropped.
+sg_u8 sg_stream_reader_next(sg_stream_reader* p_reader, sg_slice* p_slice);
+
+// Returns 0 when a read failed
+sg_u8 sg_stream_reader_close(sg_stream_reader* p_reader);
+
+// Returns 0 and leaves nothing open on failure, like sg_stream_reader_open
+sg_u8 sg_stream_writer_open(sg_stream_writer* p_writer, const char* path, sg_u64 chunk_size, sg_allocator* p_allocator);
+
+void sg_stream_writer_write(sg_stream_writer* p_writer, const void* p_data, sg_u64 size);
+
+void sg_stream_writer_write_slice(sg_stream_writer* p_writer, sg_slice* p_slice);
+
+void sg_stream_writer_write_vector(sg_stream_writer* p_writer, sg_vector* p_vector);
+
+// Flushes what is buffered and waits for it to reach the file, returns 0 when any write failed
+sg_u8 sg_stream_writer_close(sg_stream_writer* p_writer);
@@ -0,0 +1,49 @@
+#pragma once
+#include "sg_types.h"
+
+// Minimal portable threads. Handles are opaque, create and init return 0 on failure.
+
+typedef void (*sg_thread_fn)(void* p_user_data);
+
+typedef struct sg_thread
+{
+    void* _handle;
+} sg_thread;
+
+typedef struct sg_mutex
+{
+    void* _handle;
+} sg_mutex;
+
+typedef struct sg_condition
+{
+    void* _handle;
+} sg_condition;
+
+sg_u8 sg_thread_create(sg_thread* p_thread, sg_thread_fn p_fn, void* p_user_data);
+
+void sg_thread_join(sg_thread* p_thread);
+
+sg_u32 sg_thread_hardware_concurrency(void);
+
+// Gives the rest of the time slice to another ready thread
+void sg_thread_yield(void);
+
+sg_u8 sg_mutex_init(sg_mutex* p_mutex);
+
+void sg_mutex_destroy(sg_mutex* p_mutex);
+
+void sg_mutex_lock(sg_mutex* p_mutex);
+
+void sg_mutex_unlock(sg_mutex* p_mutex);
+
+sg_u8 sg_condition_init(sg_condition* p_condition);
+
+void sg_condition_destroy(sg_condition* p_condition);
+
+// Releases the mutex while waiting, wakeups may be spurious so wait in a loop on the guarded state
+void sg_condition_wait(sg_condition* p_condition, sg_mutex* p_mutex);
+
+void sg_condition_signal(sg_condition* p_condition);
+
+void sg_condition_broadcast(sg_condition* p_condition);
@@ -0,0 +1,62 @@
+#pragma once
+#include "sg_types.h"
+#include "sg_atomic.h"
+
+typedef struct sg_allocator sg_allocator;
+
+// Blocks are rounded up to power of two classes and carry a 16 byte header naming the thread cache that owns them.
+// Requests larger than the biggest class go to the parent allocator untouched by the caches.
+#define SG_THREAD_CACHE_CLASS_COUNT 8U
+#define SG_THREAD_CACHE_MIN_BLOCK 16U
+#define SG_THREAD_CACHE_HEADER 16U
+#define SG_THREAD_CACHE_MAX_BLOCKS 256U
+#define SG_THREAD_CACHE_REMOTE_BATCH 32U
+
+// A thread keeps this many allocators' caches at hand, older ones are looked up again from the allocator on overflow.
+#define SG_THREAD_CACHE_SLOTS 4U
+
+typedef struct sg_thread_cache_allocator sg_thread_cache_allocator;
+
+// Per thread state. Frees of blocks owned by another thread are batched in _pending and spliced onto the
+// owner's _remote stack with one CAS, the owner takes the whole stack back when a class runs dry.
+typedef struct sg_thread_cache
+{
+    void* volatile _remote;
+    struct sg_thread_cache* _next;
+    const void* _thread;
+    struct sg_thread_cache* _pending_owner;
+    void* _pending_head;
+    void* _pending_tail;
+    sg_u32 _pending_count;
+    void* _free[SG_THREAD_CACHE_CLASS_COUNT];
+    sg_u32 _free_count[SG_THREAD_CACHE_CLASS_COUNT];
+} sg_thread_cache;
+
+// Every thread allocating or freeing through the allocator gets its own cache of recently freed blocks.
+// Cache misses and overflow go to the parent, which must be safe to call from any thread.
+// A thread's cache lives until destroy, blocks cached by a thread that exits stay with it until then.
+struct sg_thread_cache_allocator
+{
+    sg_allocator* p_parent;
+    sg_thread_cache* _caches;
+    sg_spinlock _lock;
+    sg_u32 _id;
+    sg_u32 _max_blocks;
+};
+
+sg_thread_cache_allocator sg_thread_cache_allocator_create(sg_u32 max_blocks, sg_allocator* p_parent);
+
+// Releases every cache and cached block, all allocations must have been freed and no thread may still be using it
+void sg_thread_cache_allocator_destroy(sg_thread_cache_allocator* p_allocator);
+
+// An sg_allocator whose p_user_data is the allocator, which must stay at the same address while it is in use.
+sg_allocator sg_thread_cache_allocator_allocator(sg_thread_cache_allocator* p_allocator);
+
+void* sg_thread_cache_allocator_allocate(sg_thread_cache_allocator* p_allocator, sg_u64 size);
+
+void sg_thread_cache_allocator_free(sg_thread_cache_allocator* p_allocator, void* p_allocation);
+
+void* sg_thread_cache_allocator_realloc(sg_thread_cache_allocator* p_allocator, void* p_allocation, sg_u64 size);
+
+// Hands the calling thread's batched remote frees to their owners, call before a thread goes idle or exits
+void sg_thread_cache_allocator_flush(sg_thread_cache_allocator* p_allocator);
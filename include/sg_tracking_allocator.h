@@ -0,0 +1,59 @@
+#pragma once
+#include "sg_types.h"
+#include <stdio.h>
+
+typedef struct sg_allocator sg_allocator;
+
+// Histogram bucket i counts requests of [2^i, 2^(i+1)) bytes, the last bucket takes everything larger.
+#define SG_TRACKING_ALLOCATOR_BUCKETS 32U
+#define SG_TRACKING_ALLOCATOR_MAX_TAGS 32U
+#define SG_TRACKING_ALLOCATOR_HEADER 16U
+#define SG_TRACKING_ALLOCATOR_TAG_NONE 0U
+
+typedef struct sg_allocation_stats
+{
+    sg_u64 live_bytes;
+    sg_u64 peak_bytes;
+    sg_u64 total_bytes;
+    sg_u64 allocations;
+    sg_u64 reallocations;
+    sg_u64 frees;
+    sg_u64 histogram[SG_TRACKING_ALLOCATOR_BUCKETS];
+} sg_allocation_stats;
+
+typedef struct sg_tracking_allocator sg_tracking_allocator;
+
+typedef struct sg_tracking_tag
+{
+    sg_tracking_allocator* _owner;
+    const char* _name;
+    sg_allocation_stats _stats;
+} sg_tracking_tag;
+
+// Forwards every call to the parent and counts it against both the tag of the sg_allocator used and the total.
+// Each allocation carries a 16 byte header with its size and tag. Counters are atomic so the tracker
+// is as thread safe as its parent.
+struct sg_tracking_allocator
+{
+    sg_allocator* p_parent;
+    sg_allocation_stats _total;
+    sg_tracking_tag _tags[SG_TRACKING_ALLOCATOR_MAX_TAGS];
+    sg_u32 _tag_count;
+};
+
+sg_tracking_allocator sg_tracking_allocator_create(sg_allocator* p_parent);
+
+void sg_tracking_allocator_destroy(sg_tracking_allocator* p_tracker);
+
+// Registers a call site, returns SG_TRACKING_ALLOCATOR_TAG_NONE once every tag is taken. The name is not copied.
+sg_u32 sg_tracking_allocator_add_tag(sg_tracking_allocator* p_tracker, const char* name);
+
+// An sg_allocator counting against tag, the tracker must stay at the same address while it is in use.
+sg_allocator sg_tracking_allocator_allocator(sg_tracking_allocator* p_tracker, sg_u32 tag);
+
+sg_allocation_stats sg_tracking_allocator_stats(sg_tracking_allocator* p_tracker, sg_u32 tag);
+
+sg_allocation_stats sg_tracking_allocator_total(sg_tracking_allocator* p_tracker);
+
+// Writes the totals and every tag with its non empty histogram buckets
+void sg_tracking_allocator_dump(sg_tracking_allocator* p_tracker, FILE* p_file);
@@ -2,6 +2,7 @@
 #include <stdint.h>
 
 typedef uint8_t     sg_u8;
+typedef uint16_t    sg_u16;
 typedef uint32_t    sg_u32;
 typedef uint64_t    sg_u64;
 typedef float       sg_f32;
@@ -5,28 +5,79 @@
 
 typedef struct sg_allocator sg_allocator;
 
+// How capacity grows when push or emplace run out of room, set with sg_vector_set_growth.
+// FACTOR multiplies the capacity by amount, INCREMENT adds amount elements and PAGE grows by amount
+// like FACTOR and then rounds the bytes up to whole pages.
+#define SG_VECTOR_GROWTH_FACTOR 0U
+#define SG_VECTOR_GROWTH_INCREMENT 1U
+#define SG_VECTOR_GROWTH_PAGE 2U
+
+#define SG_VECTOR_GROWTH_DEFAULT_AMOUNT 2.0f
+
+// Returned by push and append when the vector can not grow
+#define SG_VECTOR_IDX_NULL ~0U
+
 typedef struct sg_vector
 {
     sg_buffer _buffer;
     sg_u32 _capacity;
     sg_u32 _size;
     sg_u32 _stride;
+    sg_u32 _growth;
+    sg_f32 _growth_amount;
 } sg_vector;
 
 sg_vector sg_vector_create(sg_u32 size, sg_u32 stride, sg_allocator* p_allocator);
 
+// Element 0 stays on a multiple of alignment through growth
+sg_vector sg_vector_create_aligned(sg_u32 size, sg_u32 stride, sg_u64 alignment, sg_allocator* p_allocator);
+
+// Backs the vector with a reserved address range for max_size elements, growth commits pages in place
+// so element pointers stay valid. Growing past max_size fails and leaves the vector as it was.
+sg_vector sg_vector_create_reserved(sg_u32 size, sg_u32 stride, sg_u32 max_size);
+
+// Views a file as whole elements without copying it, see sg_buffer_create_mapped. Read only vectors must not
+// be written and neither kind can grow, push, emplace and reserve fail. Slice it with sg_vector_to_slice.
+sg_vector sg_vector_create_mapped(const char* path, sg_u32 stride, sg_u8 copy_on_write, sg_u32 advice);
+
 void sg_vector_destroy(sg_vector* p_vector);
 
-void sg_vector_resize(sg_vector* p_vector, sg_u32 size);
+// Returns 0 and keeps the size when the vector can not hold size elements
+sg_u8 sg_vector_resize(sg_vector* p_vector, sg_u32 size);
+
+// Returns 0 when the capacity can not reach size
+sg_u8 sg_vector_reserve(sg_vector* p_vector, sg_u32 size);
+
+void sg_vector_set_growth(sg_vector* p_vector, sg_u32 growth, sg_f32 amount);
 
-void sg_vector_reserve(sg_vector* p_vector, sg_u32 size);
+// Drops capacity past the current size, element pointers are not stable across it
+void sg_vector_shrink_to_fit(sg_vector* p_vector);
 
+// Empties the vector and gives all of its memory back, the vector stays usable
+void sg_vector_clear_and_release(sg_vector* p_vector);
+
+// Returns NULL when the vector can not grow
 void* sg_vector_emplace(sg_vector* p_vector);
 
+// Returns the index of the element or SG_VECTOR_IDX_NULL when the vector can not grow
 sg_u32 sg_vector_push(sg_vector* p_vector, void* p_element);
 
+// Copies every element of the slice to the back with one reserve, returns the index of the first or
+// SG_VECTOR_IDX_NULL when the vector can not grow. The slice may view this vector.
+sg_u32 sg_vector_append(sg_vector* p_vector, sg_slice* p_slice);
+
+// Moves the tail up once and copies the slice in at index, the slice must not view this vector.
+// Returns 0 when the vector can not grow.
+sg_u8 sg_vector_insert_range(sg_vector* p_vector, sg_u32 index, sg_slice* p_slice);
+
 void sg_vector_erase(sg_vector* p_vector, sg_u32 index);
 
+// Removes count elements from index keeping the order, the tail moves down once
+void sg_vector_erase_range(sg_vector* p_vector, sg_u32 index, sg_u32 count);
+
+// Moves the last element into index, constant time but the order is not kept
+void sg_vector_erase_swap(sg_vector* p_vector, sg_u32 index);
+
 sg_u32 sg_vector_size(sg_vector* p_vector);
 
 sg_u8 sg_vector_any(sg_vector* p_vector);
@@ -37,14 +88,31 @@ void* sg_vector_back(sg_vector* p_vector);
 
 sg_slice sg_vector_to_slice(sg_vector* p_vector, sg_u32 offset, sg_u32 size);
 
+// Writes the elements as a flat snapshot, see sg_snapshot.h. Returns 1 on success.
+sg_u8 sg_vector_save(sg_vector* p_vector, const char* path);
+
+// Reads a snapshot into a new vector, p_vector is only written on success
+sg_u8 sg_vector_load(sg_vector* p_vector, const char* path, sg_allocator* p_allocator);
+
 #define SG_VECTOR_DEFINE_TYPE_EXT(vector_type, element_type)\
 typedef sg_vector vector_type;\
 inline vector_type vector_type##_create(sg_u32 size, sg_allocator* p_allocator) { return sg_vector_create(size, sizeof(element_type), p_allocator); }\
+inline vector_type vector_type##_create_reserved(sg_u32 size, sg_u32 max_size) { return sg_vector_create_reserved(size, sizeof(element_type), max_size); }\
+inline vector_type vector_type##_create_mapped(const char* path, sg_u8 copy_on_write, sg_u32 advice) { return sg_vector_create_mapped(path, sizeof(element_type), copy_on_write, advice); }\
+inline vector_type vector_type##_create_aligned(sg_u32 size, sg_u64 alignment, sg_allocator* p_allocator) { return sg_vector_create_aligned(size, sizeof(element_type), alignment, p_allocator); }\
 inline void vector_type##_destroy(vector_type * p_vector) { sg_vector_destroy(p_vector); }\
-inline void vector_type##_resize(vector_type * p_vector, sg_u32 size) { sg_vector_resize(p_vector, size); }\
-inline void vector_type##_reserve(vector_type * p_vector, sg_u32 size) { sg_vector_reserve(p_vector, size); }\
+inline sg_u8 vector_type##_resize(vector_type * p_vector, sg_u32 size) { return sg_vector_resize(p_vector, size); }\
+inline sg_u8 vector_type##_reserve(vector_type * p_vector, sg_u32 size) { return sg_vector_reserve(p_vector, size); }\
+inline void vector_type##_set_growth(vector_type * p_vector, sg_u32 growth, sg_f32 amount) { sg_vector_set_growth(p_vector, growth, amount); }\
+inline void vector_type##_shrink_to_fit(vector_type * p_vector) { sg_vector_shrink_to_fit(p_vector); }\
+inline void vector_type##_clear_and_release(vector_type * p_vector) { sg_vector_clear_and_release(p_vector); }\
 inline element_type* vector_type##_emplace(vector_type * p_vector) { return (element_type*)sg_vector_emplace(p_vector); }\
 inline sg_u32 vector_type##_push(vector_type * p_vector, element_type element){ return sg_vector_push(p_vector, &element); }\
+inline sg_u32 vector_type##_append(vector_type * p_vector, sg_slice* p_slice) { return sg_vector_append(p_vector, p_slice); }\
+inline sg_u8 vector_type##_insert_range(vector_type * p_vector, sg_u32 index, sg_slice* p_slice) { return sg_vector_insert_range(p_vector, index, p_slice); }\
+inline void vector_type##_erase(vector_type * p_vector, sg_u32 index) { sg_vector_erase(p_vector, index); }\
+inline void vector_type##_erase_range(vector_type * p_vector, sg_u32 index, sg_u32 count) { sg_vector_erase_range(p_vector, index, count); }\
+inline void vector_type##_erase_swap(vector_type * p_vector, sg_u32 index) { sg_vector_erase_swap(p_vector, index); }\
 inline sg_u32 vector_type##_size(vector_type * p_vector) { return sg_vector_size(p_vector); }\
 inline sg_u8 vector_type##_any(vector_type * p_vector) { return sg_vector_any(p_vector); }\
 inline element_type* vector_type##_data(vector_type * p_vector, sg_u32 index) { return (element_type*)sg_vector_data(p_vector, index); }\
@@ -0,0 +1,33 @@
+#pragma once
+#include "sg_types.h"
+
+// Thin layer over the platform page allocator, sizes and addresses passed in are multiples of the page size.
+
+sg_u64 sg_virtual_memory_page_size(void);
+
+sg_u64 sg_virtual_memory_round_up(sg_u64 size);
+
+// Reserves address space without backing it, returns NULL on failure
+void* sg_virtual_memory_reserve(sg_u64 size);
+
+// Makes pages of a reservation readable and writable, fresh pages read as zero
+sg_u8 sg_virtual_memory_commit(void* p_address, sg_u64 size);
+
+// Returns the pages to the system while keeping the address range reserved
+void sg_virtual_memory_decommit(void* p_address, sg_u64 size);
+
+void sg_virtual_memory_release(void* p_address, sg_u64 size);
+
+// Access pattern hints for mapped and committed ranges
+#define SG_VIRTUAL_MEMORY_ADVICE_NORMAL 0U
+#define SG_VIRTUAL_MEMORY_ADVICE_SEQUENTIAL 1U
+#define SG_VIRTUAL_MEMORY_ADVICE_RANDOM 2U
+#define SG_VIRTUAL_MEMORY_ADVICE_WILLNEED 3U
+
+void sg_virtual_memory_advise(void* p_address, sg_u64 size, sg_u32 advice);
+
+// Maps a whole file, copy_on_write maps it writable with private pages instead of read only.
+// Returns NULL when the file can not be opened or is empty, p_size receives the file size.
+void* sg_virtual_memory_map_file(const char* path, sg_u8 copy_on_write, sg_u32 advice, sg_u64* p_size);
+
+void sg_virtual_memory_unmap_file(void* p_address, sg_u64 size);
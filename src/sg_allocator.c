@@ -1,5 +1,18 @@
 #include "sg_allocator.h"
+#include "sg_assert.h"
 #include <stdlib.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+// Fallback aligned blocks keep the allocator's own pointer and the requested size just in front of them
+typedef struct sg_allocator_aligned_header
+{
+    void* p_allocation;
+    sg_u64 size;
+} sg_allocator_aligned_header;
 
 static inline void* sg_allocator_malloc(sg_u64 size, void* p_user_data)
 {
@@ -16,10 +29,108 @@ inline void* sg_allocator_realloc(void* p_allocation, sg_u64 size, void* p_user_
     return realloc(p_allocation, size);
 }
 
+#if defined(_MSC_VER)
+static void* sg_allocator_malloc_aligned(sg_u64 size, sg_u64 alignment, void* p_user_data)
+{
+    return _aligned_malloc(size, alignment);
+}
+
+static void sg_allocator_free_aligned_default(void* p_allocation, void* p_user_data)
+{
+    _aligned_free(p_allocation);
+}
+
+static void* sg_allocator_realloc_aligned_default(void* p_allocation, sg_u64 size, sg_u64 alignment, void* p_user_data)
+{
+    return _aligned_realloc(p_allocation, size, alignment);
+}
+#endif
+
 sg_allocator s_allocator_default =
 {
     &sg_allocator_malloc,
     &sg_allocator_free,
     &sg_allocator_realloc,
+    NULL,
+#if defined(_MSC_VER)
+    &sg_allocator_malloc_aligned,
+    &sg_allocator_free_aligned_default,
+    &sg_allocator_realloc_aligned_default
+#else
+    NULL,
+    NULL,
     NULL
-};
\ No newline at end of file
+#endif
+};
+
+static inline sg_allocator_aligned_header* sg_allocator_header(void* p_allocation)
+{
+    return (sg_allocator_aligned_header*)p_allocation - 1;
+}
+
+void* sg_allocator_allocate_aligned(sg_allocator* p_allocator, sg_u64 size, sg_u64 alignment)
+{
+    SG_ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+    if (p_allocator->allocate_aligned)
+        return p_allocator->allocate_aligned(size, alignment, p_allocator->p_user_data);
+
+    sg_u64 header_size = sizeof(sg_allocator_aligned_header);
+    sg_u8* p_allocation = (sg_u8*)p_allocator->allocate(size + alignment + header_size, p_allocator->p_user_data);
+    if (p_allocation == NULL)
+        return NULL;
+
+    sg_u64 address = ((sg_u64)(uintptr_t)p_allocation + header_size + alignment - 1) & ~(alignment - 1);
+    sg_u8* p_aligned = p_allocation + (address - (sg_u64)(uintptr_t)p_allocation);
+
+    sg_allocator_aligned_header* p_header = sg_allocator_header(p_aligned);
+    p_header->p_allocation = p_allocation;
+    p_header->size = size;
+
+    return p_aligned;
+}
+
+void sg_allocator_free_aligned(sg_allocator* p_allocator, void* p_allocation)
+{
+    if (p_allocation == NULL)
+        return;
+
+    if (p_allocator->free_aligned)
+    {
+        p_allocator->free_aligned(p_allocation, p_allocator->p_user_data);
+        return;
+    }
+
+    p_allocator->free(sg_allocator_header(p_allocation)->p_allocation, p_allocator->p_user_data);
+}
+
+void* sg_allocator_realloc_aligned(sg_allocator* p_allocator, void* p_allocation, sg_u64 size, sg_u64 alignment)
+{
+    if (p_allocator->realloc_aligned)
+        return p_allocator->realloc_aligned(p_allocation, size, alignment, p_allocator->p_user_data);
+
+    if (p_allocation == NULL)
+        return sg_allocator_allocate_aligned(p_allocator, size, alignment);
+
+    /* 1. Resize the underlying block with the allocator's realloc
+       2. Slide the data over when the block moved to an address with a different offset to the alignment */
+    sg_allocator_aligned_header* p_header = sg_allocator_header(p_allocation);
+    sg_u64 header_size = sizeof(sg_allocator_aligned_header);
+    sg_u64 old_size = p_header->size;
+    sg_u64 old_offset = (sg_u64)((sg_u8*)p_allocation - (sg_u8*)p_header->p_allocation);
+
+    sg_u8* p_reallocation = (sg_u8*)p_allocator->realloc(p_header->p_allocation, size + alignment + header_size, p_allocator->p_user_data);
+    if (p_reallocation == NULL)
+        return NULL;
+
+    sg_u64 address = ((sg_u64)(uintptr_t)p_reallocation + header_size + alignment - 1) & ~(alignment - 1);
+    sg_u64 offset = address - (sg_u64)(uintptr_t)p_reallocation;
+    if (offset != old_offset)
+        memmove(p_reallocation + offset, p_reallocation + old_offset, old_size < size ? old_size : size);
+
+    p_header = sg_allocator_header(p_reallocation + offset);
+    p_header->p_allocation = p_reallocation;
+    p_header->size = size;
+
+    return p_reallocation + offset;
+}
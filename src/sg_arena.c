@@ -0,0 +1,266 @@
+#include "sg_arena.h"
+#include "sg_allocator.h"
+#include "sg_assert.h"
+#include <string.h>
+
+static const sg_u64 s_header_size = sizeof(sg_u64);
+
+static inline sg_u64 sg_align_up(sg_u64 value, sg_u64 alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static inline sg_u8* sg_chunk_data(sg_arena_chunk* p_chunk)
+{
+    return (sg_u8*)p_chunk + sizeof(sg_arena_chunk);
+}
+
+static inline sg_u64 sg_allocation_size(void* p_allocation)
+{
+    return *(sg_u64*)((sg_u8*)p_allocation - s_header_size);
+}
+
+// Offset of the payload for an allocation placed at offset, payloads are aligned in memory rather than in the chunk
+static inline sg_u64 sg_chunk_payload_offset(sg_arena_chunk* p_chunk, sg_u64 offset, sg_u64 alignment)
+{
+    sg_u64 base = (sg_u64)(uintptr_t)sg_chunk_data(p_chunk);
+    return sg_align_up(base + offset + s_header_size, alignment) - base;
+}
+
+static inline sg_u8 sg_chunk_is_last(sg_arena_chunk* p_chunk, void* p_allocation)
+{
+    return p_chunk && (sg_u8*)p_allocation + sg_allocation_size(p_allocation) == sg_chunk_data(p_chunk) + p_chunk->_offset;
+}
+
+static sg_arena_chunk* sg_arena_push_chunk(sg_arena* p_arena, sg_u64 size, sg_u64 alignment)
+{
+    // Room for the header and worst case alignment of a single allocation
+    sg_u64 capacity = size + s_header_size + alignment;
+    if (capacity < p_arena->_chunk_size)
+        capacity = p_arena->_chunk_size;
+
+    /* 1. Reuse the first free chunk large enough
+       2. Otherwise take a new one from the parent */
+    sg_arena_chunk** pp_free = &p_arena->_free;
+    while (*pp_free && (*pp_free)->_capacity < capacity)
+        pp_free = &(*pp_free)->_prev;
+
+    sg_arena_chunk* p_chunk = *pp_free;
+    if (p_chunk)
+    {
+        *pp_free = p_chunk->_prev;
+    }
+    else
+    {
+        sg_allocator* p_parent = p_arena->p_parent;
+        p_chunk = (sg_arena_chunk*)p_parent->allocate(sizeof(sg_arena_chunk) + capacity, p_parent->p_user_data);
+        p_chunk->_capacity = capacity;
+    }
+
+    p_chunk->_prev = p_arena->_chunk;
+    p_chunk->_offset = 0;
+    p_arena->_chunk = p_chunk;
+
+    return p_chunk;
+}
+
+static void sg_arena_free_chunks(sg_arena* p_arena, sg_arena_chunk* p_chunk)
+{
+    sg_allocator* p_parent = p_arena->p_parent;
+    while (p_chunk)
+    {
+        sg_arena_chunk* p_prev = p_chunk->_prev;
+        p_parent->free(p_chunk, p_parent->p_user_data);
+        p_chunk = p_prev;
+    }
+}
+
+static void* sg_arena_allocator_allocate(sg_u64 size, void* p_user_data)
+{
+    return sg_arena_allocate((sg_arena*)p_user_data, size);
+}
+
+static void sg_arena_allocator_free(void* p_allocation, void* p_user_data)
+{
+    sg_arena_free((sg_arena*)p_user_data, p_allocation);
+}
+
+static void* sg_arena_allocator_realloc(void* p_allocation, sg_u64 size, void* p_user_data)
+{
+    return sg_arena_realloc((sg_arena*)p_user_data, p_allocation, size);
+}
+
+static void* sg_arena_allocator_allocate_aligned(sg_u64 size, sg_u64 alignment, void* p_user_data)
+{
+    return sg_arena_allocate_aligned((sg_arena*)p_user_data, size, alignment);
+}
+
+static void* sg_arena_allocator_realloc_aligned(void* p_allocation, sg_u64 size, sg_u64 alignment, void* p_user_data)
+{
+    return sg_arena_realloc_aligned((sg_arena*)p_user_data, p_allocation, size, alignment);
+}
+
+sg_arena sg_arena_create(sg_u64 chunk_size, sg_allocator* p_parent)
+{
+    if (p_parent == NULL)
+        p_parent = &s_allocator_default;
+
+    if (chunk_size == 0)
+        chunk_size = SG_ARENA_CHUNK_SIZE;
+
+    sg_arena arena;
+    arena.p_parent = p_parent;
+    arena._chunk = NULL;
+    arena._free = NULL;
+    arena._chunk_size = chunk_size;
+    return arena;
+}
+
+void sg_arena_destroy(sg_arena* p_arena)
+{
+    if (p_arena->p_parent)
+    {
+        sg_arena_free_chunks(p_arena, p_arena->_chunk);
+        sg_arena_free_chunks(p_arena, p_arena->_free);
+    }
+
+    p_arena->p_parent = NULL;
+    p_arena->_chunk = NULL;
+    p_arena->_free = NULL;
+    p_arena->_chunk_size = 0;
+}
+
+sg_allocator sg_arena_allocator(sg_arena* p_arena)
+{
+    sg_allocator allocator =
+    {
+        &sg_arena_allocator_allocate,
+        &sg_arena_allocator_free,
+        &sg_arena_allocator_realloc,
+        p_arena,
+        &sg_arena_allocator_allocate_aligned,
+        &sg_arena_allocator_free,
+        &sg_arena_allocator_realloc_aligned
+    };
+
+    return allocator;
+}
+
+void* sg_arena_allocate(sg_arena* p_arena, sg_u64 size)
+{
+    return sg_arena_allocate_aligned(p_arena, size, SG_ARENA_ALIGNMENT);
+}
+
+void* sg_arena_allocate_aligned(sg_arena* p_arena, sg_u64 size, sg_u64 alignment)
+{
+    SG_ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+    if (alignment < SG_ARENA_ALIGNMENT)
+        alignment = SG_ARENA_ALIGNMENT;
+
+    sg_arena_chunk* p_chunk = p_arena->_chunk;
+    sg_u64 payload = 0;
+    if (p_chunk)
+        payload = sg_chunk_payload_offset(p_chunk, p_chunk->_offset, alignment);
+
+    if (p_chunk == NULL || payload + size > p_chunk->_capacity)
+    {
+        p_chunk = sg_arena_push_chunk(p_arena, size, alignment);
+        payload = sg_chunk_payload_offset(p_chunk, 0, alignment);
+    }
+
+    sg_u8* p_allocation = sg_chunk_data(p_chunk) + payload;
+    *(sg_u64*)(p_allocation - s_header_size) = size;
+    p_chunk->_offset = payload + size;
+
+    return p_allocation;
+}
+
+void sg_arena_free(sg_arena* p_arena, void* p_allocation)
+{
+    if (p_allocation == NULL)
+        return;
+
+    // Only the top of the current chunk can be handed back
+    sg_arena_chunk* p_chunk = p_arena->_chunk;
+    if (sg_chunk_is_last(p_chunk, p_allocation))
+        p_chunk->_offset = (sg_u64)((sg_u8*)p_allocation - s_header_size - sg_chunk_data(p_chunk));
+}
+
+void* sg_arena_realloc(sg_arena* p_arena, void* p_allocation, sg_u64 size)
+{
+    return sg_arena_realloc_aligned(p_arena, p_allocation, size, SG_ARENA_ALIGNMENT);
+}
+
+void* sg_arena_realloc_aligned(sg_arena* p_arena, void* p_allocation, sg_u64 size, sg_u64 alignment)
+{
+    if (p_allocation == NULL)
+        return sg_arena_allocate_aligned(p_arena, size, alignment);
+
+    /* 1. The top allocation grows or shrinks in place while it fits its chunk
+       2. Anything else moves to a new allocation, the old one stays until reset */
+    sg_arena_chunk* p_chunk = p_arena->_chunk;
+    sg_u64 old_size = sg_allocation_size(p_allocation);
+    if (sg_chunk_is_last(p_chunk, p_allocation) && ((uintptr_t)p_allocation & (alignment - 1)) == 0)
+    {
+        sg_u64 payload = (sg_u64)((sg_u8*)p_allocation - sg_chunk_data(p_chunk));
+        if (payload + size <= p_chunk->_capacity)
+        {
+            *(sg_u64*)((sg_u8*)p_allocation - s_header_size) = size;
+            p_chunk->_offset = payload + size;
+            return p_allocation;
+        }
+    }
+
+    void* p_reallocation = sg_arena_allocate_aligned(p_arena, size, alignment);
+    memcpy_s(p_reallocation, size, p_allocation, old_size < size ? old_size : size);
+
+    return p_reallocation;
+}
+
+sg_arena_mark sg_arena_get_mark(sg_arena* p_arena)
+{
+    sg_arena_mark mark;
+    mark._chunk = p_arena->_chunk;
+    mark._offset = p_arena->_chunk ? p_arena->_chunk->_offset : 0;
+    return mark;
+}
+
+void sg_arena_reset(sg_arena* p_arena, sg_arena_mark mark)
+{
+    // Chunks pushed after the mark go to the free list
+    while (p_arena->_chunk != mark._chunk)
+    {
+        sg_arena_chunk* p_chunk = p_arena->_chunk;
+        SG_ASSERT(p_chunk != NULL);
+
+        p_arena->_chunk = p_chunk->_prev;
+        p_chunk->_prev = p_arena->_free;
+        p_arena->_free = p_chunk;
+    }
+
+    if (p_arena->_chunk)
+    {
+        SG_ASSERT(mark._offset <= p_arena->_chunk->_offset);
+        p_arena->_chunk->_offset = mark._offset;
+    }
+}
+
+void sg_arena_clear(sg_arena* p_arena)
+{
+    sg_arena_mark mark = { NULL, 0 };
+    sg_arena_reset(p_arena, mark);
+}
+
+sg_u64 sg_arena_size(sg_arena* p_arena)
+{
+    sg_u64 size = 0;
+    sg_arena_chunk* p_chunk = p_arena->_chunk;
+    while (p_chunk)
+    {
+        size += p_chunk->_offset;
+        p_chunk = p_chunk->_prev;
+    }
+
+    return size;
+}
@@ -0,0 +1,36 @@
+#include "sg_atomic.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sched.h>
+#endif
+
+static const sg_u32 s_spin_count = 64;
+
+static inline void sg_yield(void)
+{
+#if defined(_WIN32)
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+void sg_spinlock_lock_contended(volatile sg_spinlock* p_lock)
+{
+    sg_u32 spin = 0;
+    while (!sg_spinlock_try_lock(p_lock))
+    {
+        if (spin < s_spin_count)
+        {
+            SG_ATOMIC_PAUSE();
+            spin += 1;
+        }
+        else
+        {
+            sg_yield();
+        }
+    }
+}
@@ -0,0 +1,162 @@
+#include "sg_atomic_hash_table.h"
+#include "sg_allocator.h"
+#include "sg_assert.h"
+#include "sg_atomic.h"
+#include <string.h>
+
+static inline sg_u32 sg_hash(sg_u32 key)
+{
+    // Same Fibonacci hash and slot mapping as sg_hash_table
+    return (sg_u32)((11400714819323198485ull * (sg_u64)key) & 0xffffffff);
+}
+
+static inline sg_u32 sg_idx_start(sg_u32 hash, sg_u32 table_size)
+{
+    return (sg_u32)(((sg_u64)hash * (sg_u64)table_size) >> 32ull);
+}
+
+static inline sg_u32 sg_idx_next(sg_u32 idx, sg_u32 capacity)
+{
+    idx += 1;
+    if (idx == capacity) return 0;
+    return idx;
+}
+
+sg_atomic_hash_table sg_atomic_hash_table_create(sg_u32 capacity, sg_u32 stride, sg_allocator* p_allocator)
+{
+    SG_ASSERT(capacity != 0);
+
+    if (p_allocator == NULL)
+        p_allocator = &s_allocator_default;
+
+    sg_atomic_hash_table table;
+    table.p_allocator = p_allocator;
+    table._keys = (sg_u32*)p_allocator->allocate(sizeof(sg_u32) * capacity, p_allocator->p_user_data);
+    table._data = (sg_u8*)p_allocator->allocate((sg_u64)stride * capacity, p_allocator->p_user_data);
+    table._capacity = capacity;
+    table._size = 0;
+    table._stride = stride;
+
+    sg_atomic_hash_table_clear(&table);
+
+    return table;
+}
+
+void sg_atomic_hash_table_destroy(sg_atomic_hash_table* p_table)
+{
+    if (p_table->_keys)
+        p_table->p_allocator->free(p_table->_keys, p_table->p_allocator->p_user_data);
+
+    if (p_table->_data)
+        p_table->p_allocator->free(p_table->_data, p_table->p_allocator->p_user_data);
+
+    p_table->p_allocator = NULL;
+    p_table->_keys = NULL;
+    p_table->_data = NULL;
+    p_table->_capacity = 0;
+    p_table->_size = 0;
+    p_table->_stride = 0;
+}
+
+void sg_atomic_hash_table_clear(sg_atomic_hash_table* p_table)
+{
+    memset(p_table->_keys, 0xff, sizeof(sg_u32) * p_table->_capacity);
+    memset(p_table->_data, 0, (size_t)((sg_u64)p_table->_stride * p_table->_capacity));
+    sg_atomic_store_u32(&p_table->_size, 0);
+}
+
+sg_u32 sg_atomic_hash_table_size(sg_atomic_hash_table* p_table)
+{
+    return sg_atomic_load_u32(&p_table->_size);
+}
+
+sg_u32 sg_atomic_hash_table_capacity(sg_atomic_hash_table* p_table)
+{
+    return p_table->_capacity;
+}
+
+sg_u8 sg_atomic_hash_table_find(sg_atomic_hash_table* p_table, sg_u32 key)
+{
+    sg_u32 idx = SG_HASH_TABLE_IDX_NULL;
+    return sg_atomic_hash_table_find_index(p_table, key, &idx);
+}
+
+sg_u8 sg_atomic_hash_table_find_index(sg_atomic_hash_table* p_table, sg_u32 key, sg_u32* p_idx)
+{
+    SG_ASSERT(key != SG_HASH_TABLE_KEY_NULL);
+
+    // Keys are never removed so the first empty slot ends the probe
+    sg_u32 capacity = p_table->_capacity;
+    sg_u32 idx = sg_idx_start(sg_hash(key), capacity);
+    sg_u32 probe = 0;
+    while (probe < capacity)
+    {
+        sg_u32 slot_key = sg_atomic_load_u32(p_table->_keys + idx);
+        if (slot_key == key)
+        {
+            *p_idx = idx;
+            return 1;
+        }
+
+        if (slot_key == SG_HASH_TABLE_KEY_NULL)
+            break;
+
+        idx = sg_idx_next(idx, capacity);
+        probe += 1;
+    }
+
+    *p_idx = SG_HASH_TABLE_IDX_NULL;
+    return 0;
+}
+
+sg_u8 sg_atomic_hash_table_find_value(sg_atomic_hash_table* p_table, sg_u32 key, void** pp_value)
+{
+    sg_u32 idx = SG_HASH_TABLE_IDX_NULL;
+    sg_u8 found = sg_atomic_hash_table_find_index(p_table, key, &idx);
+    if (pp_value)
+        *pp_value = found ? p_table->_data + (sg_u64)idx * p_table->_stride : NULL;
+    return found;
+}
+
+void* sg_atomic_hash_table_emplace(sg_atomic_hash_table* p_table, sg_u32 key)
+{
+    SG_ASSERT(key != SG_HASH_TABLE_KEY_NULL);
+
+    sg_u32 capacity = p_table->_capacity;
+    sg_u32 idx = sg_idx_start(sg_hash(key), capacity);
+    sg_u32 probe = 0;
+    while (probe < capacity)
+    {
+        sg_u32 slot_key = sg_atomic_load_u32(p_table->_keys + idx);
+        if (slot_key == SG_HASH_TABLE_KEY_NULL)
+        {
+            // Losing the race to another key moves on, losing it to the same key shares the slot
+            slot_key = sg_atomic_cas_u32(p_table->_keys + idx, SG_HASH_TABLE_KEY_NULL, key);
+            if (slot_key == SG_HASH_TABLE_KEY_NULL)
+            {
+                sg_atomic_fetch_add_u32(&p_table->_size, 1);
+                return p_table->_data + (sg_u64)idx * p_table->_stride;
+            }
+        }
+
+        if (slot_key == key)
+            return p_table->_data + (sg_u64)idx * p_table->_stride;
+
+        idx = sg_idx_next(idx, capacity);
+        probe += 1;
+    }
+
+    return NULL;
+}
+
+void* sg_atomic_hash_table_value(sg_atomic_hash_table* p_table, sg_u32 idx)
+{
+    SG_ASSERT(idx < p_table->_capacity);
+    return p_table->_data + (sg_u64)idx * p_table->_stride;
+}
+
+sg_u32 sg_atomic_hash_table_key(sg_atomic_hash_table* p_table, sg_u32 idx)
+{
+    SG_ASSERT(idx < p_table->_capacity);
+    return sg_atomic_load_u32(p_table->_keys + idx);
+}
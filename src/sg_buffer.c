@@ -1,44 +1,180 @@
 #include "sg_buffer.h"
 #include "sg_allocator.h"
 #include "sg_assert.h"
+#include "sg_virtual_memory.h"
+
+// Commits whole pages, returns 1 when at least size bytes are committed. Sizes past the reservation fail
+// even when they would fit in its last page.
+static sg_u8 sg_buffer_commit(sg_buffer* p_buffer, sg_u64 size)
+{
+    if (size > p_buffer->reserved)
+        return 0;
+
+    sg_u64 commit_size = sg_virtual_memory_round_up(size);
+
+    if (commit_size > p_buffer->size && sg_virtual_memory_commit(p_buffer->allocation + p_buffer->size, commit_size - p_buffer->size))
+        p_buffer->size = commit_size;
+
+    return p_buffer->size >= size;
+}
 
 sg_buffer sg_buffer_create(sg_u64 size, sg_allocator* p_allocator)
 {
+    return sg_buffer_create_aligned(size, 0, p_allocator);
+}
+
+sg_buffer sg_buffer_create_aligned(sg_u64 size, sg_u64 alignment, sg_allocator* p_allocator)
+{
+    SG_ASSERT((alignment & (alignment - 1)) == 0);
+
     if (p_allocator == NULL)
         p_allocator = &s_allocator_default;
 
     void* p_allocation = NULL;
     if (size != 0)
-        p_allocation = (sg_u8*)p_allocator->allocate(size, p_allocator->p_user_data);
+    {
+        if (alignment)
+            p_allocation = (sg_u8*)sg_allocator_allocate_aligned(p_allocator, size, alignment);
+        else
+            p_allocation = (sg_u8*)p_allocator->allocate(size, p_allocator->p_user_data);
+    }
 
     sg_buffer buffer;
     buffer.allocator = (sg_allocator* const)p_allocator;
     buffer.allocation = p_allocation;
     buffer.size = size;
+    buffer.alignment = alignment;
+    buffer.reserved = 0;
+    buffer.mapped = 0;
+    return buffer;
+}
+
+sg_buffer sg_buffer_create_reserved(sg_u64 size, sg_u64 reserve_size)
+{
+    SG_ASSERT(size <= reserve_size);
+
+    sg_buffer buffer;
+    buffer.allocator = NULL;
+    buffer.allocation = NULL;
+    buffer.size = 0;
+    buffer.alignment = 0;
+    buffer.reserved = reserve_size;
+    buffer.mapped = 0;
+
+    buffer.allocation = (sg_u8*)sg_virtual_memory_reserve(sg_virtual_memory_round_up(reserve_size));
+    SG_ASSERT(buffer.allocation);
+    if (buffer.allocation == NULL)
+        buffer.reserved = 0;
+    else if (size != 0)
+        sg_buffer_commit(&buffer, size);
+
+    return buffer;
+}
+
+sg_buffer sg_buffer_create_mapped(const char* path, sg_u8 copy_on_write, sg_u32 advice)
+{
+    sg_u64 size = 0;
+
+    sg_buffer buffer;
+    buffer.allocator = NULL;
+    buffer.allocation = (sg_u8*)sg_virtual_memory_map_file(path, copy_on_write, advice, &size);
+    buffer.size = size;
+    buffer.alignment = 0;
+    buffer.reserved = 0;
+    buffer.mapped = buffer.allocation != NULL;
     return buffer;
 }
 
+void sg_buffer_advise(sg_buffer* p_buffer, sg_u32 advice)
+{
+    SG_ASSERT(p_buffer->mapped || p_buffer->reserved);
+
+    if (p_buffer->allocation && p_buffer->size)
+        sg_virtual_memory_advise(p_buffer->allocation, p_buffer->size, advice);
+}
+
 void sg_buffer_destroy(sg_buffer* p_buffer)
 {
     void* p_allocation = p_buffer->allocation;
     if (p_allocation)
-        p_buffer->allocator->free(p_allocation, p_buffer->allocator->p_user_data);
+    {
+        if (p_buffer->mapped)
+            sg_virtual_memory_unmap_file(p_allocation, p_buffer->size);
+        else if (p_buffer->reserved)
+            sg_virtual_memory_release(p_allocation, sg_virtual_memory_round_up(p_buffer->reserved));
+        else if (p_buffer->alignment)
+            sg_allocator_free_aligned(p_buffer->allocator, p_allocation);
+        else
+            p_buffer->allocator->free(p_allocation, p_buffer->allocator->p_user_data);
+    }
 
     p_buffer->allocator = NULL;
     p_buffer->allocation = NULL;
     p_buffer->size = 0;
+    p_buffer->alignment = 0;
+    p_buffer->reserved = 0;
+    p_buffer->mapped = 0;
 }
 
-void sg_buffer_resize(sg_buffer* p_buffer, sg_u64 size)
+sg_u8 sg_buffer_resize(sg_buffer* p_buffer, sg_u64 size)
 {
     if (p_buffer->size < size)
     {
-        p_buffer->allocation = p_buffer->allocator->realloc(p_buffer->allocation, size, p_buffer->allocator->p_user_data);
+        // Mapped buffers have no allocator and keep the file size
+        if (p_buffer->mapped)
+            return 0;
+
+        if (p_buffer->reserved)
+            return sg_buffer_commit(p_buffer, size);
+
+        if (p_buffer->alignment)
+            p_buffer->allocation = sg_allocator_realloc_aligned(p_buffer->allocator, p_buffer->allocation, size, p_buffer->alignment);
+        else
+            p_buffer->allocation = p_buffer->allocator->realloc(p_buffer->allocation, size, p_buffer->allocator->p_user_data);
         p_buffer->size = size;
     }
+
+    return 1;
+}
+
+void sg_buffer_shrink(sg_buffer* p_buffer, sg_u64 size)
+{
+    if (p_buffer->size <= size || p_buffer->mapped)
+        return;
+
+    if (p_buffer->reserved)
+    {
+        size = sg_virtual_memory_round_up(size);
+        if (size < p_buffer->size)
+        {
+            sg_virtual_memory_decommit(p_buffer->allocation + size, p_buffer->size - size);
+            p_buffer->size = size;
+        }
+
+        return;
+    }
+
+    if (size == 0)
+    {
+        if (p_buffer->alignment)
+            sg_allocator_free_aligned(p_buffer->allocator, p_buffer->allocation);
+        else
+            p_buffer->allocator->free(p_buffer->allocation, p_buffer->allocator->p_user_data);
+        p_buffer->allocation = NULL;
+    }
+    else if (p_buffer->alignment)
+    {
+        p_buffer->allocation = sg_allocator_realloc_aligned(p_buffer->allocator, p_buffer->allocation, size, p_buffer->alignment);
+    }
+    else
+    {
+        p_buffer->allocation = p_buffer->allocator->realloc(p_buffer->allocation, size, p_buffer->allocator->p_user_data);
+    }
+
+    p_buffer->size = size;
 }
 
-void* sg_buffer_data(sg_buffer* p_buffer, sg_u32 offset)
+void* sg_buffer_data(sg_buffer* p_buffer, sg_u64 offset)
 {
     if (p_buffer->allocation != NULL)
         return p_buffer->allocation + offset;
@@ -0,0 +1,226 @@
+#include "sg_concurrent_hash_table.h"
+#include "sg_allocator.h"
+#include "sg_assert.h"
+#include <string.h>
+
+static const sg_u32 s_maximum_shard_bits = 16;
+
+static inline sg_u32 sg_shard_bits(sg_u32 shard_count)
+{
+    sg_u32 bits = 0;
+    while ((1U << bits) < shard_count && bits < s_maximum_shard_bits)
+        bits += 1;
+
+    return bits;
+}
+
+static inline sg_concurrent_hash_table_shard* sg_shard(sg_concurrent_hash_table* p_table, const void* p_key)
+{
+    // Every shard hashes the same way, shard 0 stands in for all of them
+    if (p_table->_shard_bits == 0)
+        return p_table->_shards;
+
+    sg_u32 hash = sg_hash_table_hash(&p_table->_shards[0]._table, p_key);
+    return p_table->_shards + (hash >> (32U - p_table->_shard_bits));
+}
+
+static inline sg_u8 sg_frozen(sg_concurrent_hash_table* p_table)
+{
+    return sg_atomic_load_u32(&p_table->_frozen) != 0;
+}
+
+sg_concurrent_hash_table sg_concurrent_hash_table_create(sg_u32 shard_count, sg_u32 capacity, sg_u32 stride, sg_f32 load_factor, sg_allocator* p_allocator)
+{
+    return sg_concurrent_hash_table_create_ext(shard_count, capacity, sizeof(sg_u32), stride, load_factor, NULL, NULL, p_allocator);
+}
+
+sg_concurrent_hash_table sg_concurrent_hash_table_create_ext(sg_u32 shard_count, sg_u32 capacity, sg_u32 key_stride, sg_u32 stride, sg_f32 load_factor, sg_hash_table_hash_fn p_hash, sg_hash_table_equal_fn p_equal, sg_allocator* p_allocator)
+{
+    if (p_allocator == NULL)
+        p_allocator = &s_allocator_default;
+
+    sg_u32 shard_bits = sg_shard_bits(shard_count);
+    shard_count = 1U << shard_bits;
+
+    sg_concurrent_hash_table table;
+    table.p_allocator = p_allocator;
+    table._shards = (sg_concurrent_hash_table_shard*)p_allocator->allocate(sizeof(sg_concurrent_hash_table_shard) * shard_count, p_allocator->p_user_data);
+    table._shard_count = shard_count;
+    table._shard_bits = shard_bits;
+    table._frozen = 0;
+
+    sg_u32 shard_capacity = capacity / shard_count;
+    sg_u32 i = 0;
+    while (i < shard_count)
+    {
+        sg_concurrent_hash_table_shard* p_shard = table._shards + i;
+        p_shard->_table = sg_hash_table_create_ext(shard_capacity, key_stride, stride, load_factor, p_hash, p_equal, p_allocator);
+        p_shard->_table._hash_shift = shard_bits;
+        p_shard->_lock = 0;
+        i += 1;
+    }
+
+    return table;
+}
+
+void sg_concurrent_hash_table_destroy(sg_concurrent_hash_table* p_table)
+{
+    if (p_table->_shards)
+    {
+        sg_u32 i = 0;
+        while (i < p_table->_shard_count)
+        {
+            sg_hash_table_destroy(&p_table->_shards[i]._table);
+            i += 1;
+        }
+
+        p_table->p_allocator->free(p_table->_shards, p_table->p_allocator->p_user_data);
+    }
+
+    p_table->p_allocator = NULL;
+    p_table->_shards = NULL;
+    p_table->_shard_count = 0;
+    p_table->_shard_bits = 0;
+    p_table->_frozen = 0;
+}
+
+sg_u32 sg_concurrent_hash_table_size(sg_concurrent_hash_table* p_table)
+{
+    sg_u8 frozen = sg_frozen(p_table);
+    sg_u32 size = 0;
+    sg_u32 i = 0;
+    while (i < p_table->_shard_count)
+    {
+        sg_concurrent_hash_table_shard* p_shard = p_table->_shards + i;
+        if (!frozen) sg_spinlock_lock(&p_shard->_lock);
+        size += sg_hash_table_size(&p_shard->_table);
+        if (!frozen) sg_spinlock_unlock(&p_shard->_lock);
+        i += 1;
+    }
+
+    return size;
+}
+
+sg_u8 sg_concurrent_hash_table_find(sg_concurrent_hash_table* p_table, sg_u32 key)
+{
+    SG_ASSERT(p_table->_shards[0]._table._key_stride == sizeof(sg_u32));
+    return sg_concurrent_hash_table_find_key_value(p_table, &key, NULL);
+}
+
+sg_u8 sg_concurrent_hash_table_find_value(sg_concurrent_hash_table* p_table, sg_u32 key, void* p_value)
+{
+    SG_ASSERT(p_table->_shards[0]._table._key_stride == sizeof(sg_u32));
+    return sg_concurrent_hash_table_find_key_value(p_table, &key, p_value);
+}
+
+sg_u8 sg_concurrent_hash_table_insert(sg_concurrent_hash_table* p_table, sg_u32 key, void* p_value)
+{
+    SG_ASSERT(p_table->_shards[0]._table._key_stride == sizeof(sg_u32));
+    return sg_concurrent_hash_table_insert_key(p_table, &key, p_value);
+}
+
+sg_u8 sg_concurrent_hash_table_remove(sg_concurrent_hash_table* p_table, sg_u32 key)
+{
+    SG_ASSERT(p_table->_shards[0]._table._key_stride == sizeof(sg_u32));
+    return sg_concurrent_hash_table_remove_key(p_table, &key);
+}
+
+sg_u8 sg_concurrent_hash_table_find_key(sg_concurrent_hash_table* p_table, const void* p_key)
+{
+    return sg_concurrent_hash_table_find_key_value(p_table, p_key, NULL);
+}
+
+sg_u8 sg_concurrent_hash_table_find_key_value(sg_concurrent_hash_table* p_table, const void* p_key, void* p_value)
+{
+    sg_concurrent_hash_table_shard* p_shard = sg_shard(p_table, p_key);
+    void* p_found = NULL;
+
+    // Frozen tables have no migration in flight so the lookup below never writes
+    if (sg_frozen(p_table))
+    {
+        sg_u8 found = sg_hash_table_find_key_value(&p_shard->_table, p_key, &p_found);
+        if (found && p_value)
+            memcpy_s(p_value, p_shard->_table._stride, p_found, p_shard->_table._stride);
+
+        return found;
+    }
+
+    sg_spinlock_lock(&p_shard->_lock);
+    sg_u8 found = sg_hash_table_find_key_value(&p_shard->_table, p_key, &p_found);
+    if (found && p_value)
+        memcpy_s(p_value, p_shard->_table._stride, p_found, p_shard->_table._stride);
+    sg_spinlock_unlock(&p_shard->_lock);
+
+    return found;
+}
+
+sg_u8 sg_concurrent_hash_table_insert_key(sg_concurrent_hash_table* p_table, const void* p_key, void* p_value)
+{
+    SG_ASSERT(!sg_frozen(p_table));
+
+    sg_concurrent_hash_table_shard* p_shard = sg_shard(p_table, p_key);
+    sg_u8 inserted = 0;
+
+    sg_spinlock_lock(&p_shard->_lock);
+    if (!sg_hash_table_find_key(&p_shard->_table, p_key))
+    {
+        sg_hash_table_insert_key(&p_shard->_table, p_key, p_value);
+        inserted = 1;
+    }
+    sg_spinlock_unlock(&p_shard->_lock);
+
+    return inserted;
+}
+
+sg_u8 sg_concurrent_hash_table_remove_key(sg_concurrent_hash_table* p_table, const void* p_key)
+{
+    SG_ASSERT(!sg_frozen(p_table));
+
+    sg_concurrent_hash_table_shard* p_shard = sg_shard(p_table, p_key);
+    sg_u32 idx = SG_HASH_TABLE_IDX_NULL;
+
+    sg_spinlock_lock(&p_shard->_lock);
+    sg_u8 found = sg_hash_table_find_key_index(&p_shard->_table, p_key, &idx);
+    if (found)
+        sg_hash_table_remove_at_index(&p_shard->_table, idx);
+    sg_spinlock_unlock(&p_shard->_lock);
+
+    return found;
+}
+
+sg_hash_table* sg_concurrent_hash_table_lock(sg_concurrent_hash_table* p_table, const void* p_key)
+{
+    SG_ASSERT(!sg_frozen(p_table));
+
+    sg_concurrent_hash_table_shard* p_shard = sg_shard(p_table, p_key);
+    sg_spinlock_lock(&p_shard->_lock);
+    return &p_shard->_table;
+}
+
+void sg_concurrent_hash_table_unlock(sg_concurrent_hash_table* p_table, sg_hash_table* p_shard_table)
+{
+    // The table is the first member of its shard
+    sg_concurrent_hash_table_shard* p_shard = (sg_concurrent_hash_table_shard*)p_shard_table;
+    SG_ASSERT(p_shard >= p_table->_shards && p_shard < p_table->_shards + p_table->_shard_count);
+    sg_spinlock_unlock(&p_shard->_lock);
+}
+
+void sg_concurrent_hash_table_freeze(sg_concurrent_hash_table* p_table)
+{
+    sg_u32 i = 0;
+    while (i < p_table->_shard_count)
+    {
+        sg_concurrent_hash_table_shard* p_shard = p_table->_shards + i;
+        sg_spinlock_lock(&p_shard->_lock);
+        sg_hash_table_migrate(&p_shard->_table, SG_HASH_TABLE_IDX_NULL);
+        sg_spinlock_unlock(&p_shard->_lock);
+        i += 1;
+    }
+
+    sg_atomic_store_u32(&p_table->_frozen, 1);
+}
+
+void sg_concurrent_hash_table_thaw(sg_concurrent_hash_table* p_table)
+{
+    sg_atomic_store_u32(&p_table->_frozen, 0);
+}
@@ -0,0 +1,277 @@
+#include "sg_cpu.h"
+#include "sg_assert.h"
+#include "sg_atomic.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if SG_CPU_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+static const char* s_level_names[SG_CPU_LEVEL_COUNT] = { "scalar", "sse2", "avx2", "avx512" };
+
+static sg_cpu_features s_features;
+static sg_cpu_dispatch s_dispatch[SG_CPU_LEVEL_COUNT];
+static sg_cpu_dispatch* volatile s_p_active = NULL;
+static sg_spinlock s_init_lock = 0;
+
+static void sg_memclear_scalar(void* p_data, sg_u64 size)
+{
+    memset(p_data, 0, (size_t)size);
+}
+
+#if SG_CPU_X86
+
+static inline sg_u8* sg_memclear_head(sg_u8* p_bytes, sg_u64 alignment)
+{
+    sg_u64 head = (alignment - ((uintptr_t)p_bytes & (alignment - 1))) & (alignment - 1);
+    memset(p_bytes, 0, (size_t)head);
+    return p_bytes + head;
+}
+
+// Large clears stream whole registers past the cache instead of evicting everything through it.
+// The fence orders the streamed stores before any later ones.
+
+SG_CPU_TARGET_SSE2 static void sg_memclear_sse2(void* p_data, sg_u64 size)
+{
+    if (size < SG_CPU_STREAM_THRESHOLD)
+    {
+        memset(p_data, 0, (size_t)size);
+        return;
+    }
+
+    sg_u8* p_end = (sg_u8*)p_data + size;
+    sg_u8* p_bytes = sg_memclear_head((sg_u8*)p_data, 16);
+    __m128i zero = _mm_setzero_si128();
+    while (p_bytes + 16 <= p_end)
+    {
+        _mm_stream_si128((__m128i*)p_bytes, zero);
+        p_bytes += 16;
+    }
+
+    memset(p_bytes, 0, (size_t)(p_end - p_bytes));
+    _mm_sfence();
+}
+
+SG_CPU_TARGET_AVX2 static void sg_memclear_avx2(void* p_data, sg_u64 size)
+{
+    if (size < SG_CPU_STREAM_THRESHOLD)
+    {
+        memset(p_data, 0, (size_t)size);
+        return;
+    }
+
+    sg_u8* p_end = (sg_u8*)p_data + size;
+    sg_u8* p_bytes = sg_memclear_head((sg_u8*)p_data, 32);
+    __m256i zero = _mm256_setzero_si256();
+    while (p_bytes + 32 <= p_end)
+    {
+        _mm256_stream_si256((__m256i*)p_bytes, zero);
+        p_bytes += 32;
+    }
+
+    memset(p_bytes, 0, (size_t)(p_end - p_bytes));
+    _mm_sfence();
+}
+
+SG_CPU_TARGET_AVX512 static void sg_memclear_avx512(void* p_data, sg_u64 size)
+{
+    if (size < SG_CPU_STREAM_THRESHOLD)
+    {
+        memset(p_data, 0, (size_t)size);
+        return;
+    }
+
+    sg_u8* p_end = (sg_u8*)p_data + size;
+    sg_u8* p_bytes = sg_memclear_head((sg_u8*)p_data, 64);
+    __m512i zero = _mm512_setzero_si512();
+    while (p_bytes + 64 <= p_end)
+    {
+        _mm512_stream_si512((void*)p_bytes, zero);
+        p_bytes += 64;
+    }
+
+    memset(p_bytes, 0, (size_t)(p_end - p_bytes));
+    _mm_sfence();
+}
+
+static void sg_cpuid(sg_u32 leaf, sg_u32 subleaf, sg_u32* p_registers)
+{
+#if defined(_MSC_VER)
+    int registers[4];
+    __cpuidex(registers, (int)leaf, (int)subleaf);
+    memcpy(p_registers, registers, sizeof(registers));
+#else
+    __cpuid_count(leaf, subleaf, p_registers[0], p_registers[1], p_registers[2], p_registers[3]);
+#endif
+}
+
+static sg_u64 sg_xgetbv(void)
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    sg_u32 lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return ((sg_u64)hi << 32) | lo;
+#endif
+}
+
+#endif
+
+static sg_cpu_features sg_cpu_query(void)
+{
+    sg_cpu_features features;
+    memset(&features, 0, sizeof(sg_cpu_features));
+    features.level = SG_CPU_LEVEL_SCALAR;
+
+#if SG_CPU_X86
+    /* 1. Leaf 1 for SSE, POPCNT and AVX, leaf 7 for AVX2, BMI and AVX-512
+       2. Wide registers only count when the OS saves them on a context switch, checked with xgetbv */
+    sg_u32 registers[4];
+    sg_cpuid(0, 0, registers);
+    sg_u32 max_leaf = registers[0];
+
+    sg_cpuid(1, 0, registers);
+    features.sse2 = (registers[3] >> 26) & 1;
+    features.sse41 = (registers[2] >> 19) & 1;
+    features.sse42 = (registers[2] >> 20) & 1;
+    features.popcnt = (registers[2] >> 23) & 1;
+
+    sg_u8 osxsave = (registers[2] >> 27) & 1;
+    sg_u64 xcr0 = osxsave ? sg_xgetbv() : 0;
+    sg_u8 ymm = (xcr0 & 0x6) == 0x6;
+    sg_u8 zmm = (xcr0 & 0xE6) == 0xE6;
+    features.avx = ymm && ((registers[2] >> 28) & 1);
+
+    if (max_leaf >= 7)
+    {
+        sg_cpuid(7, 0, registers);
+        features.avx2 = features.avx && ((registers[1] >> 5) & 1);
+        features.bmi1 = (registers[1] >> 3) & 1;
+        features.bmi2 = (registers[1] >> 8) & 1;
+        features.avx512f = zmm && ((registers[1] >> 16) & 1);
+        features.avx512bw = zmm && ((registers[1] >> 30) & 1);
+    }
+
+    if (features.sse2)
+        features.level = SG_CPU_LEVEL_SSE2;
+    if (features.level == SG_CPU_LEVEL_SSE2 && features.avx2)
+        features.level = SG_CPU_LEVEL_AVX2;
+    if (features.level == SG_CPU_LEVEL_AVX2 && features.avx512f && features.avx512bw)
+        features.level = SG_CPU_LEVEL_AVX512;
+#endif
+
+    return features;
+}
+
+static void sg_cpu_fill(sg_cpu_dispatch* p_dispatch, sg_u32 level)
+{
+    memset(p_dispatch, 0, sizeof(sg_cpu_dispatch));
+    p_dispatch->level = level;
+    p_dispatch->p_memclear = &sg_memclear_scalar;
+#if SG_CPU_X86
+    if (level == SG_CPU_LEVEL_SSE2)
+        p_dispatch->p_memclear = &sg_memclear_sse2;
+    else if (level == SG_CPU_LEVEL_AVX2)
+        p_dispatch->p_memclear = &sg_memclear_avx2;
+    else if (level == SG_CPU_LEVEL_AVX512)
+        p_dispatch->p_memclear = &sg_memclear_avx512;
+#endif
+
+    sg_slice_kernels_fill(p_dispatch, level);
+}
+
+static sg_cpu_dispatch* sg_cpu_init(void)
+{
+    sg_spinlock_lock(&s_init_lock);
+
+    sg_cpu_dispatch* p_active = (sg_cpu_dispatch*)sg_atomic_load_ptr((void* const volatile*)&s_p_active);
+    if (p_active == NULL)
+    {
+        /* 1. Detect once
+           2. Fill a table for every supported level so switching is a pointer swap
+           3. Start at the detected level, capped by the environment */
+        s_features = sg_cpu_query();
+
+        sg_u32 level = 0;
+        while (level <= s_features.level)
+        {
+            sg_cpu_fill(s_dispatch + level, level);
+            level += 1;
+        }
+
+        level = s_features.level;
+        const char* p_override = getenv(SG_CPU_LEVEL_ENV);
+        if (p_override)
+        {
+            sg_u32 cap = sg_cpu_level_parse(p_override);
+            if (cap != SG_CPU_LEVEL_NULL && cap < level)
+                level = cap;
+        }
+
+        p_active = s_dispatch + level;
+        sg_atomic_exchange_ptr((void* volatile*)&s_p_active, p_active);
+    }
+
+    sg_spinlock_unlock(&s_init_lock);
+    return p_active;
+}
+
+sg_cpu_features sg_cpu_detect(void)
+{
+    sg_cpu_dispatch_table();
+    return s_features;
+}
+
+const sg_cpu_dispatch* sg_cpu_dispatch_table(void)
+{
+    sg_cpu_dispatch* p_active = (sg_cpu_dispatch*)sg_atomic_load_ptr((void* const volatile*)&s_p_active);
+    if (p_active == NULL)
+        p_active = sg_cpu_init();
+
+    return p_active;
+}
+
+sg_u32 sg_cpu_level(void)
+{
+    return sg_cpu_dispatch_table()->level;
+}
+
+sg_u32 sg_cpu_set_level(sg_u32 level)
+{
+    sg_cpu_dispatch_table();
+
+    if (level > s_features.level)
+        level = s_features.level;
+
+    sg_atomic_exchange_ptr((void* volatile*)&s_p_active, s_dispatch + level);
+    return level;
+}
+
+const char* sg_cpu_level_name(sg_u32 level)
+{
+    return level < SG_CPU_LEVEL_COUNT ? s_level_names[level] : "unknown";
+}
+
+sg_u32 sg_cpu_level_parse(const char* p_name)
+{
+    if (p_name[0] >= '0' && (sg_u32)(p_name[0] - '0') < SG_CPU_LEVEL_COUNT && p_name[1] == '\0')
+        return (sg_u32)(p_name[0] - '0');
+
+    sg_u32 level = 0;
+    while (level < SG_CPU_LEVEL_COUNT)
+    {
+        if (strcmp(p_name, s_level_names[level]) == 0)
+            return level;
+
+        level += 1;
+    }
+
+    return SG_CPU_LEVEL_NULL;
+}
@@ -1,60 +1,257 @@
 #include "sg_hash_table.h"
 #include "sg_allocator.h"
 #include "sg_assert.h"
+#include "sg_snapshot.h"
 #include <math.h>
+#include <string.h>
 
-static const sg_u32 s_minimum_capacity = 4;
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SG_HASH_TABLE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+static const sg_u32 s_minimum_capacity = SG_HASH_TABLE_GROUP_WIDTH;
+
+// Batches hash this many keys up front and prefetch the start slots this far ahead of the probe
+#define SG_HASH_TABLE_BATCH_BLOCK 64U
+#define SG_HASH_TABLE_PREFETCH_DISTANCE 8U
 
 static inline sg_f32 sg_load_factor(sg_u32 size, sg_u32 capacity)
 {
     return (sg_f32)size / (sg_f32)capacity;
 }
 
-static inline sg_u32 sg_probe_length(sg_u32 idx_start, sg_u32 idx, sg_u32 capacity)
+static inline sg_u32 sg_hash(sg_u32 key)
+{
+    // https://probablydance.com/2018/06/16/fibonacci-hashing-the-optimization-that-the-world-forgot-or-a-better-alternative-to-integer-modulo/
+    return (sg_u32)((11400714819323198485ull * (sg_u64)key) & 0xffffffff);
+}
+
+static inline sg_u32 sg_hash64(sg_u64 key)
 {
-    if (idx_start <= idx) return idx - idx_start;
-    return idx + capacity - idx_start;
+    // Every bit of the key reaches the high half of the product
+    return (sg_u32)((11400714819323198485ull * key) >> 32ull);
 }
 
-static inline sg_u32 sg_idx_start(sg_u32 key, sg_u32 table_size)
+static inline sg_u32 sg_hash_bytes(const void* p_key, sg_u32 size)
 {
-    // https://probablydance.com/2018/06/16/fibonacci-hashing-the-optimization-that-the-world-forgot-or-a-better-alternative-to-integer-modulo/
-    sg_u64 fib = (11400714819323198485ull * (sg_u64)key) & 0xffffffff;
-    return (sg_u32)((fib * (sg_u64)table_size) >> 32ull);
+    // FNV-1a
+    static const sg_u32 basis = 0x811c9dc5;
+    static const sg_u32 prime = 0x01000193;
+
+    const sg_u8* p_bytes = (const sg_u8*)p_key;
+    sg_u32 hash = basis;
+    sg_u32 i = 0;
+    while (i < size)
+    {
+        hash ^= p_bytes[i];
+        hash *= prime;
+        i += 1;
+    }
+
+    return hash;
+}
+
+static inline sg_u32 sg_hash_key_full(const sg_hash_table* p_table, const void* p_key)
+{
+    if (p_table->_hash)
+        return sg_hash(p_table->_hash(p_key, p_table->_key_stride));
+
+    if (p_table->_key_stride == sizeof(sg_u32))
+        return sg_hash(*(const sg_u32*)p_key);
+
+    if (p_table->_key_stride == sizeof(sg_u64))
+        return sg_hash64(*(const sg_u64*)p_key);
+
+    return sg_hash(sg_hash_bytes(p_key, p_table->_key_stride));
+}
+
+static inline sg_u32 sg_hash_key(const sg_hash_table* p_table, const void* p_key)
+{
+    return sg_hash_key_full(p_table, p_key) << p_table->_hash_shift;
+}
+
+static inline sg_u8 sg_key_equal(const sg_hash_table* p_table, const sg_u8* p_slot_key, const void* p_key)
+{
+    if (p_table->_equal)
+        return p_table->_equal(p_slot_key, p_key, p_table->_key_stride);
+
+    if (p_table->_key_stride == sizeof(sg_u32))
+        return *(const sg_u32*)p_slot_key == *(const sg_u32*)p_key;
+
+    if (p_table->_key_stride == sizeof(sg_u64))
+        return *(const sg_u64*)p_slot_key == *(const sg_u64*)p_key;
+
+    return memcmp(p_slot_key, p_key, p_table->_key_stride) == 0;
+}
+
+static inline sg_u8* sg_key_at(const sg_hash_table* p_table, sg_u32 idx)
+{
+    return p_table->_keys + idx * p_table->_key_stride;
+}
+
+static inline sg_u32 sg_idx_start(sg_u32 hash, sg_u32 table_size)
+{
+    return (sg_u32)(((sg_u64)hash * (sg_u64)table_size) >> 32ull);
+}
+
+static inline sg_u8 sg_tag(sg_u32 hash)
+{
+    // The high bits pick the slot so take the tag from the middle of the hash
+    return (sg_u8)((hash >> 16) & 0x7f);
+}
+
+static inline sg_u32 sg_idx_wrap(sg_u32 idx, sg_u32 capacity)
+{
+    if (idx >= capacity) return idx - capacity;
+    return idx;
+}
+
+static inline sg_u32 sg_ctz(sg_u32 mask)
+{
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward(&idx, mask);
+    return (sg_u32)idx;
+#else
+    return (sg_u32)__builtin_ctz(mask);
+#endif
+}
+
+static inline void sg_prefetch(const void* p_data)
+{
+#if SG_HASH_TABLE_SSE2
+    _mm_prefetch((const char*)p_data, _MM_HINT_T0);
+#elif defined(__GNUC__)
+    __builtin_prefetch(p_data);
+#else
+    (void)p_data;
+#endif
+}
+
+static inline sg_u32 sg_group_match(const sg_u8* p_ctrl, sg_u8 value)
+{
+#if SG_HASH_TABLE_SSE2
+    __m128i group = _mm_loadu_si128((const __m128i*)p_ctrl);
+    return (sg_u32)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)value)));
+#else
+    sg_u32 mask = 0;
+    sg_u32 lane = 0;
+    while (lane < SG_HASH_TABLE_GROUP_WIDTH)
+    {
+        if (p_ctrl[lane] == value)
+            mask |= 1U << lane;
+
+        lane += 1;
+    }
+
+    return mask;
+#endif
+}
+
+static inline sg_u32 sg_group_stop(const sg_u8* p_dist, sg_u32 probe)
+{
+    // Lanes where the resident entry is closer to its start slot than we are to ours, empty lanes always stop
+#if SG_HASH_TABLE_SSE2
+    if (probe > SG_HASH_TABLE_DIST_MAX)
+        probe = SG_HASH_TABLE_DIST_MAX;
+
+    __m128i lanes = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m128i probes = _mm_adds_epi8(_mm_set1_epi8((char)probe), lanes);
+    __m128i group = _mm_loadu_si128((const __m128i*)p_dist);
+    return (sg_u32)_mm_movemask_epi8(_mm_cmplt_epi8(group, probes));
+#else
+    sg_u32 mask = 0;
+    sg_u32 lane = 0;
+    while (lane < SG_HASH_TABLE_GROUP_WIDTH)
+    {
+        sg_u8 dist = p_dist[lane];
+        if (dist == SG_HASH_TABLE_DIST_EMPTY || dist < probe + lane)
+            mask |= 1U << lane;
+
+        lane += 1;
+    }
+
+    return mask;
+#endif
+}
+
+static inline sg_u8 sg_ctrl_full(sg_u8 ctrl)
+{
+    // Empty and moved slots both have the high bit set
+    return (ctrl & SG_HASH_TABLE_CTRL_EMPTY) == 0;
+}
+
+static inline void sg_set_ctrl_at(sg_u8* p_ctrl, sg_u8* p_dist, sg_u32 capacity, sg_u32 idx, sg_u8 tag, sg_u8 dist)
+{
+    p_ctrl[idx] = tag;
+    p_dist[idx] = dist;
+    if (idx < SG_HASH_TABLE_GROUP_WIDTH)
+    {
+        p_ctrl[capacity + idx] = tag;
+        p_dist[capacity + idx] = dist;
+    }
+}
+
+static inline void sg_set_ctrl(sg_hash_table* p_table, sg_u32 idx, sg_u8 tag, sg_u8 dist)
+{
+    sg_set_ctrl_at(p_table->_ctrl, p_table->_dist, p_table->_capacity, idx, tag, dist);
 }
 
-static inline sg_u8 sg_search(sg_u32* p_keys, sg_u32 key, sg_u32 capacity, sg_u32 probe_length, sg_u32* p_idx)
+static inline sg_u8 sg_search_slots(const sg_hash_table* p_table, const sg_u8* p_ctrl, const sg_u8* p_dist, const sg_u8* p_keys, sg_u32 capacity, sg_u32 hash, const void* p_key, sg_u32* p_idx)
 {
     /*
     1. find the start idx
-    2. loop(max probe_lenth) until matching hash has been found
+    2. loop a group at a time until a matching tag and key has been found
+    3. stop on the first slot that is empty or holds an entry closer to its start than the probe
     */
-    sg_u32 idx_start = sg_idx_start(key, capacity);
-    sg_u32 idx = idx_start;
+    sg_u8 tag = sg_tag(hash);
+    sg_u32 base = sg_idx_start(hash, capacity);
     sg_u32 probe = 0;
-    while (probe <= probe_length)
+    while (probe <= SG_HASH_TABLE_DIST_MAX)
     {
-        if (idx > capacity)
-            idx = idx - capacity;
+        sg_u32 match = sg_group_match(p_ctrl + base, tag);
+        sg_u32 stop = sg_group_stop(p_dist + base, probe);
+        if (stop)
+            match &= (stop & (0U - stop)) - 1U;
 
-        if (p_keys[idx] == key)
+        while (match)
         {
-            if (p_idx)
-                *p_idx = idx;
+            sg_u32 idx = sg_idx_wrap(base + sg_ctz(match), capacity);
+            if (sg_key_equal(p_table, p_keys + idx * p_table->_key_stride, p_key))
+            {
+                if (p_idx)
+                    *p_idx = idx;
 
-            return 1;
+                return 1;
+            }
+
+            match &= match - 1;
         }
 
-        idx += 1;
-        probe += 1;
+        if (stop)
+            break;
+
+        base = sg_idx_wrap(base + SG_HASH_TABLE_GROUP_WIDTH, capacity);
+        probe += SG_HASH_TABLE_GROUP_WIDTH;
     }
 
     return 0;
 }
 
-static inline void sg_erase_key(sg_u32* p_keys, sg_u32 idx)
+static inline sg_u8 sg_search(sg_hash_table* p_table, sg_u32 hash, const void* p_key, sg_u32* p_idx)
+{
+    return sg_search_slots(p_table, p_table->_ctrl, p_table->_dist, p_table->_keys, p_table->_capacity, hash, p_key, p_idx);
+}
+
+static inline void sg_erase_key(sg_hash_table* p_table, sg_u32 idx)
 {
-    p_keys[idx] = SG_HASH_TABLE_KEY_NULL;
+    sg_set_ctrl(p_table, idx, SG_HASH_TABLE_CTRL_EMPTY, SG_HASH_TABLE_DIST_EMPTY);
+    memset(sg_key_at(p_table, idx), SG_HASH_TABLE_KEY_NULL, p_table->_key_stride);
 }
 
 static inline void sg_erase_val(sg_u8* p_data, sg_u32 idx, sg_u32 stride)
@@ -62,50 +259,192 @@ static inline void sg_erase_val(sg_u8* p_data, sg_u32 idx, sg_u32 stride)
     memset(p_data + idx * stride, SG_HASH_TABLE_VAL_NULL, stride);
 }
 
-static inline void sg_hash_table_rehash(sg_hash_table* p_table, sg_u32* p_keys, sg_u8* p_data, sg_u32 capacity)
+static inline void sg_move_slot(sg_hash_table* p_table, sg_u32 idx_dst, sg_u32 idx_src, sg_u8 dist)
+{
+    sg_set_ctrl(p_table, idx_dst, p_table->_ctrl[idx_src], dist);
+    memcpy_s(sg_key_at(p_table, idx_dst), p_table->_key_stride, sg_key_at(p_table, idx_src), p_table->_key_stride);
+    memcpy_s(p_table->_data + idx_dst * p_table->_stride, p_table->_stride, p_table->_data + idx_src * p_table->_stride, p_table->_stride);
+}
+
+static void sg_hash_table_resize(sg_hash_table* p_table, sg_u32 capacity);
+
+/*
+    1. Find start slot
+    2. Loop a group at a time until a slot is empty or holds an entry closer to its start slot than the probe
+    3. Shift the run up to the next empty slot down by one, each displaced entry moves once
+    4. Insert, grow instead if any distance would pass the maximum
+*/
+static sg_u32 sg_emplace(sg_hash_table* p_table, sg_u32 hash, const void* p_key)
+{
+    while (1)
+    {
+        sg_u32 capacity = p_table->_capacity;
+        sg_u32 base = sg_idx_start(hash, capacity);
+        sg_u32 probe = 0;
+        sg_u32 stop = 0;
+        while (probe <= SG_HASH_TABLE_DIST_MAX)
+        {
+            stop = sg_group_stop(p_table->_dist + base, probe);
+            if (stop)
+                break;
+
+            base = sg_idx_wrap(base + SG_HASH_TABLE_GROUP_WIDTH, capacity);
+            probe += SG_HASH_TABLE_GROUP_WIDTH;
+        }
+
+        sg_u32 lane = stop ? sg_ctz(stop) : 0;
+        sg_u32 idx = sg_idx_wrap(base + lane, capacity);
+        probe += lane;
+
+        sg_u8 overflow = !stop || probe > SG_HASH_TABLE_DIST_MAX;
+        sg_u32 idx_empty = idx;
+        while (!overflow && p_table->_dist[idx_empty] != SG_HASH_TABLE_DIST_EMPTY)
+        {
+            if (p_table->_dist[idx_empty] == SG_HASH_TABLE_DIST_MAX)
+                overflow = 1;
+
+            idx_empty = sg_idx_wrap(idx_empty + 1, capacity);
+        }
+
+        if (overflow)
+        {
+            sg_hash_table_resize(p_table, capacity * 2U);
+            continue;
+        }
+
+        while (idx_empty != idx)
+        {
+            sg_u32 idx_prev = idx_empty ? idx_empty - 1 : capacity - 1;
+            sg_move_slot(p_table, idx_empty, idx_prev, p_table->_dist[idx_prev] + 1);
+            idx_empty = idx_prev;
+        }
+
+        sg_set_ctrl(p_table, idx, sg_tag(hash), (sg_u8)probe);
+        memcpy_s(sg_key_at(p_table, idx), p_table->_key_stride, p_key, p_table->_key_stride);
+        p_table->_size += 1;
+
+        return idx;
+    }
+}
+
+static inline void sg_hash_table_rehash(sg_hash_table* p_table, sg_u8* p_ctrl, sg_u8* p_keys, sg_u8* p_data, sg_u32 capacity)
 {
     sg_u32 idx = 0;
     while (idx < capacity)
     {
-        sg_u32 key = p_keys[idx];
-        if (key != SG_HASH_TABLE_KEY_NULL)
+        if (sg_ctrl_full(p_ctrl[idx]))
         {
-            sg_hash_table_insert(p_table, key, p_data + idx * p_table->_stride);
+            sg_u8* p_key = p_keys + idx * p_table->_key_stride;
+            sg_u32 idx_new = sg_emplace(p_table, sg_hash_key(p_table, p_key), p_key);
+            memcpy_s(p_table->_data + idx_new * p_table->_stride, p_table->_stride, p_data + idx * p_table->_stride, p_table->_stride);
         }
 
         idx += 1;
     }
 }
 
-static inline void sg_hash_table_resize(sg_hash_table* p_table, sg_u32 capacity)
+static inline void sg_hash_table_alloc_slots_uninitialized(sg_hash_table* p_table, sg_u32 capacity)
+{
+    // Control and distance bytes get a trailing group that mirrors the first one so groups never wrap
+    sg_u64 ctrl_data_length = (sg_u64)capacity + SG_HASH_TABLE_GROUP_WIDTH;
+    sg_u64 key_data_length = (sg_u64)capacity * p_table->_key_stride;
+    sg_u64 val_data_length = (sg_u64)capacity * p_table->_stride;
+
+    p_table->_ctrl = (sg_u8*)p_table->p_allocator->allocate(ctrl_data_length, p_table->p_allocator->p_user_data);
+    p_table->_dist = (sg_u8*)p_table->p_allocator->allocate(ctrl_data_length, p_table->p_allocator->p_user_data);
+    p_table->_keys = (sg_u8*)p_table->p_allocator->allocate(key_data_length, p_table->p_allocator->p_user_data);
+    p_table->_data = (sg_u8*)p_table->p_allocator->allocate(val_data_length, p_table->p_allocator->p_user_data);
+    p_table->_capacity = capacity;
+}
+
+static inline void sg_hash_table_alloc_slots(sg_hash_table* p_table, sg_u32 capacity)
 {
+    sg_u64 ctrl_data_length = (sg_u64)capacity + SG_HASH_TABLE_GROUP_WIDTH;
+    sg_u64 key_data_length = (sg_u64)capacity * p_table->_key_stride;
+    sg_u64 val_data_length = (sg_u64)capacity * p_table->_stride;
+
+    sg_hash_table_alloc_slots_uninitialized(p_table, capacity);
+
+    memset(p_table->_ctrl, SG_HASH_TABLE_CTRL_EMPTY, ctrl_data_length);
+    memset(p_table->_dist, SG_HASH_TABLE_DIST_EMPTY, ctrl_data_length);
+    memset(p_table->_keys, SG_HASH_TABLE_KEY_NULL, key_data_length);
+    memset(p_table->_data, SG_HASH_TABLE_VAL_NULL, val_data_length);
+}
+
+static inline void sg_hash_table_free_slots(sg_hash_table* p_table, sg_u8* p_ctrl, sg_u8* p_dist, sg_u8* p_keys, sg_u8* p_data)
+{
+    if (p_ctrl) p_table->p_allocator->free(p_ctrl, p_table->p_allocator->p_user_data);
+    if (p_dist) p_table->p_allocator->free(p_dist, p_table->p_allocator->p_user_data);
+    if (p_keys) p_table->p_allocator->free(p_keys, p_table->p_allocator->p_user_data);
+    if (p_data) p_table->p_allocator->free(p_data, p_table->p_allocator->p_user_data);
+}
+
+static inline void sg_hash_table_release_prev(sg_hash_table* p_table)
+{
+    sg_hash_table_free_slots(p_table, p_table->_prev_ctrl, p_table->_prev_dist, p_table->_prev_keys, p_table->_prev_data);
+    p_table->_prev_ctrl = NULL;
+    p_table->_prev_dist = NULL;
+    p_table->_prev_keys = NULL;
+    p_table->_prev_data = NULL;
+    p_table->_prev_capacity = 0;
+    p_table->_migrate_idx = 0;
+}
+
+static void sg_hash_table_resize(sg_hash_table* p_table, sg_u32 capacity)
+{
+    // Rebuilds the current arrays in place, a previous generation that is still migrating is left alone
     if (p_table->_capacity < capacity)
     {
-        sg_u32 size_prev = p_table->_size;
-        sg_u64 capacity_prev = p_table->_capacity;
-        sg_u64 capacity_curr = capacity;
+        sg_u32 size = p_table->_size;
+        sg_u32 capacity_prev = p_table->_capacity;
 
-        sg_u32* p_keys = p_table->_keys;
+        sg_u8* p_ctrl = p_table->_ctrl;
+        sg_u8* p_dist = p_table->_dist;
+        sg_u8* p_keys = p_table->_keys;
         sg_u8* p_data = p_table->_data;
 
-        // Alloc 1 space more than necessary for capacity and use that to swap during remove
-        sg_u64 key_data_length = capacity_curr * sizeof(sg_u32);
-        sg_u64 val_data_length = (1 + capacity_curr) * p_table->_stride; 
+        sg_hash_table_alloc_slots(p_table, capacity);
 
-        p_table->_keys = (sg_u32*)p_table->p_allocator->allocate(key_data_length, p_table->p_allocator->p_user_data);
-        p_table->_data = (sg_u8*)p_table->p_allocator->allocate(val_data_length, p_table->p_allocator->p_user_data);
-        p_table->_capacity = capacity_curr;
-        p_table->_size = 0;
+        if (p_ctrl)
+            sg_hash_table_rehash(p_table, p_ctrl, p_keys, p_data, capacity_prev);
 
-        memset(p_table->_keys, SG_HASH_TABLE_KEY_NULL, key_data_length);
-        memset(p_table->_data, SG_HASH_TABLE_VAL_NULL, val_data_length);
+        p_table->_size = size;
 
-        if (size_prev)
-            sg_hash_table_rehash(p_table, p_keys, p_data, capacity_prev);
+        sg_hash_table_free_slots(p_table, p_ctrl, p_dist, p_keys, p_data);
+    }
+}
+
+static inline sg_u32 sg_hash_table_migrate_slot(sg_hash_table* p_table, sg_u32 idx, sg_u32 hash)
+{
+    // The distance stays behind so lookups still walk past the moved slot
+    sg_u8* p_key = p_table->_prev_keys + idx * p_table->_key_stride;
+    sg_set_ctrl_at(p_table->_prev_ctrl, p_table->_prev_dist, p_table->_prev_capacity, idx, SG_HASH_TABLE_CTRL_MOVED, p_table->_prev_dist[idx]);
+    p_table->_size -= 1;
+
+    sg_u32 idx_new = sg_emplace(p_table, hash, p_key);
+    memcpy_s(p_table->_data + idx_new * p_table->_stride, p_table->_stride, p_table->_prev_data + idx * p_table->_stride, p_table->_stride);
+    return idx_new;
+}
 
-        if (p_keys) p_table->p_allocator->free(p_keys, p_table->p_allocator->p_user_data);
-        if (p_data) p_table->p_allocator->free(p_data, p_table->p_allocator->p_user_data);
+static inline void sg_hash_table_grow(sg_hash_table* p_table, sg_u32 capacity)
+{
+    if (p_table->_migrate_step == 0 || p_table->_size == 0)
+    {
+        sg_hash_table_resize(p_table, capacity);
+        return;
     }
+
+    // Only two generations are ever live, finish the last one before starting over
+    sg_hash_table_migrate(p_table, SG_HASH_TABLE_IDX_NULL);
+
+    p_table->_prev_ctrl = p_table->_ctrl;
+    p_table->_prev_dist = p_table->_dist;
+    p_table->_prev_keys = p_table->_keys;
+    p_table->_prev_data = p_table->_data;
+    p_table->_prev_capacity = p_table->_capacity;
+    p_table->_migrate_idx = 0;
+
+    sg_hash_table_alloc_slots(p_table, capacity);
 }
 
 static inline void sg_hash_table_resize_if_necessary(sg_hash_table* p_table)
@@ -123,24 +462,80 @@ static inline void sg_hash_table_resize_if_necessary(sg_hash_table* p_table)
         if (capacity < s_minimum_capacity)
             capacity = s_minimum_capacity;
 
-        sg_hash_table_resize(p_table, capacity);
+        sg_hash_table_grow(p_table, capacity);
+    }
+}
+
+static inline void sg_prefetch_slot(sg_hash_table* p_table, sg_u32 hash, sg_u8 prefetch_data)
+{
+    sg_u32 idx = sg_idx_start(hash, p_table->_capacity);
+    sg_prefetch(p_table->_ctrl + idx);
+    sg_prefetch(p_table->_dist + idx);
+    sg_prefetch(sg_key_at(p_table, idx));
+    if (prefetch_data)
+        sg_prefetch(p_table->_data + idx * p_table->_stride);
+}
+
+static inline sg_u8 sg_find(sg_hash_table* p_table, const void* p_key, sg_u32* p_idx)
+{
+    /*
+    1. migrate a bounded number of buckets when a resize is in flight
+    2. search the current arrays
+    3. search the previous arrays and pull a hit across so the index refers to the current arrays
+    */
+    if (p_table->_prev_ctrl)
+        sg_hash_table_migrate(p_table, p_table->_migrate_step);
+
+    sg_u32 hash = sg_hash_key(p_table, p_key);
+    if (sg_search(p_table, hash, p_key, p_idx))
+        return 1;
+
+    sg_u32 idx_prev = SG_HASH_TABLE_IDX_NULL;
+    if (p_table->_prev_ctrl && sg_search_slots(p_table, p_table->_prev_ctrl, p_table->_prev_dist, p_table->_prev_keys, p_table->_prev_capacity, hash, p_key, &idx_prev))
+    {
+        sg_u32 idx = sg_hash_table_migrate_slot(p_table, idx_prev, hash);
+        if (p_idx)
+            *p_idx = idx;
+
+        return 1;
     }
+
+    return 0;
 }
 
 
 sg_hash_table sg_hash_table_create(sg_u32 capacity, sg_u32 stride, sg_f32 load_factor, sg_allocator* p_allocator)
 {
+    return sg_hash_table_create_ext(capacity, sizeof(sg_u32), stride, load_factor, NULL, NULL, p_allocator);
+}
+
+sg_hash_table sg_hash_table_create_ext(sg_u32 capacity, sg_u32 key_stride, sg_u32 stride, sg_f32 load_factor, sg_hash_table_hash_fn p_hash, sg_hash_table_equal_fn p_equal, sg_allocator* p_allocator)
+{
+    SG_ASSERT(key_stride != 0);
+
     if (p_allocator == NULL)
         p_allocator = &s_allocator_default;
 
     sg_hash_table table;
     table.p_allocator = p_allocator;
+    table._hash = p_hash;
+    table._equal = p_equal;
+    table._ctrl = NULL;
+    table._dist = NULL;
     table._keys = NULL;
     table._data = NULL;
+    table._prev_ctrl = NULL;
+    table._prev_dist = NULL;
+    table._prev_keys = NULL;
+    table._prev_data = NULL;
     table._capacity = 0;
+    table._prev_capacity = 0;
+    table._migrate_idx = 0;
+    table._migrate_step = 0;
     table._size = 0;
+    table._key_stride = key_stride;
     table._stride = stride;
-    table._probe_length = 0;
+    table._hash_shift = 0;
     table._load_factor = load_factor;
 
     if (capacity < s_minimum_capacity)
@@ -153,20 +548,23 @@ sg_hash_table sg_hash_table_create(sg_u32 capacity, sg_u32 stride, sg_f32 load_f
 
 void sg_hash_table_destroy(sg_hash_table* p_table)
 {
-    if (p_table->_keys)
-        p_table->p_allocator->free(p_table->_keys, p_table->p_allocator->p_user_data);
-
-    if (p_table->_data)
-        p_table->p_allocator->free(p_table->_data, p_table->p_allocator->p_user_data);
+    sg_hash_table_release_prev(p_table);
+    sg_hash_table_free_slots(p_table, p_table->_ctrl, p_table->_dist, p_table->_keys, p_table->_data);
 
     p_table->p_allocator = NULL;
+    p_table->_hash = NULL;
+    p_table->_equal = NULL;
+    p_table->_ctrl = NULL;
+    p_table->_dist = NULL;
     p_table->_keys = NULL;
     p_table->_data = NULL;
     p_table->_capacity = 0;
+    p_table->_migrate_step = 0;
     p_table->_size = 0;
+    p_table->_key_stride = 0;
     p_table->_stride = 0;
+    p_table->_hash_shift = 0;
     p_table->_load_factor = 0.0f;
-    p_table->_probe_length = 0;
 }
 
 void sg_hash_table_reserve(sg_hash_table* p_table, sg_u32 size)
@@ -178,6 +576,40 @@ void sg_hash_table_reserve(sg_hash_table* p_table, sg_u32 size)
     sg_hash_table_resize(p_table, capacity);
 }   
 
+void sg_hash_table_set_incremental(sg_hash_table* p_table, sg_u32 migrate_step)
+{
+    if (migrate_step == 0)
+        sg_hash_table_migrate(p_table, SG_HASH_TABLE_IDX_NULL);
+
+    p_table->_migrate_step = migrate_step;
+}
+
+sg_u8 sg_hash_table_migrate(sg_hash_table* p_table, sg_u32 bucket_count)
+{
+    while (bucket_count && p_table->_prev_ctrl)
+    {
+        sg_u32 idx = p_table->_migrate_idx;
+        if (sg_ctrl_full(p_table->_prev_ctrl[idx]))
+        {
+            sg_u8* p_key = p_table->_prev_keys + idx * p_table->_key_stride;
+            sg_hash_table_migrate_slot(p_table, idx, sg_hash_key(p_table, p_key));
+        }
+
+        p_table->_migrate_idx = idx + 1;
+        if (p_table->_migrate_idx == p_table->_prev_capacity)
+            sg_hash_table_release_prev(p_table);
+
+        bucket_count -= 1;
+    }
+
+    return p_table->_prev_ctrl != NULL;
+}
+
+sg_u32 sg_hash_table_hash(sg_hash_table* p_table, const void* p_key)
+{
+    return sg_hash_key_full(p_table, p_key);
+}
+
 sg_u32 sg_hash_table_size(sg_hash_table* p_table)
 {
     return p_table->_size;
@@ -190,18 +622,36 @@ sg_u32 sg_hash_table_capacity(sg_hash_table* p_table)
 
 sg_u8 sg_hash_table_find(sg_hash_table* p_table, sg_u32 key)
 {
-    return sg_search(p_table->_keys, key, p_table->_capacity, p_table->_probe_length, NULL);
+    SG_ASSERT(p_table->_key_stride == sizeof(sg_u32));
+    return sg_find(p_table, &key, NULL);
 }
 
 sg_u8 sg_hash_table_find_index(sg_hash_table* p_table, sg_u32 key, sg_u32* p_idx)
 {
-    return sg_search(p_table->_keys, key, p_table->_capacity, p_table->_probe_length, p_idx);
+    SG_ASSERT(p_table->_key_stride == sizeof(sg_u32));
+    return sg_find(p_table, &key, p_idx);
 }
 
 sg_u8 sg_hash_table_find_value(sg_hash_table* p_table, sg_u32 key, void** pp_data)
+{
+    SG_ASSERT(p_table->_key_stride == sizeof(sg_u32));
+    return sg_hash_table_find_key_value(p_table, &key, pp_data);
+}
+
+sg_u8 sg_hash_table_find_key(sg_hash_table* p_table, const void* p_key)
+{
+    return sg_find(p_table, p_key, NULL);
+}
+
+sg_u8 sg_hash_table_find_key_index(sg_hash_table* p_table, const void* p_key, sg_u32* p_idx)
+{
+    return sg_find(p_table, p_key, p_idx);
+}
+
+sg_u8 sg_hash_table_find_key_value(sg_hash_table* p_table, const void* p_key, void** pp_data)
 {
     sg_u32 idx = SG_HASH_TABLE_IDX_NULL;
-    sg_u8 found = sg_search(p_table->_keys, key, p_table->_capacity, p_table->_probe_length, &idx);
+    sg_u8 found = sg_find(p_table, p_key, &idx);
     if (found)
     {
         if (pp_data)
@@ -211,78 +661,168 @@ sg_u8 sg_hash_table_find_value(sg_hash_table* p_table, sg_u32 key, void** pp_dat
     return found;
 }
 
+void* sg_hash_table_key(sg_hash_table* p_table, sg_u32 idx)
+{
+    SG_ASSERT(idx < p_table->_capacity);
+    return sg_key_at(p_table, idx);
+}
 
-/*
-    1. Find start slot
-    2. Loop (capacity) until null hash is found
-    3. Insert
-*/
 void* sg_hash_table_emplace(sg_hash_table* p_table, sg_u32 key)
 {
+    SG_ASSERT(p_table->_key_stride == sizeof(sg_u32));
+    return sg_hash_table_emplace_key(p_table, &key);
+}
+
+void* sg_hash_table_emplace_key(sg_hash_table* p_table, const void* p_key)
+{
+    if (p_table->_prev_ctrl)
+        sg_hash_table_migrate(p_table, p_table->_migrate_step);
+
     sg_hash_table_resize_if_necessary(p_table);
 
-    sg_u32 idx_start = sg_idx_start(key, p_table->_capacity);
-    sg_u32 idx = idx_start;
-    sg_u32 probe = 0;
-    while (1)
+    sg_u32 idx = sg_emplace(p_table, sg_hash_key(p_table, p_key), p_key);
+    return p_table->_data + idx * p_table->_stride;
+}
+
+void sg_hash_table_insert(sg_hash_table* p_table, sg_u32 key, void* p_value)
+{
+    SG_ASSERT(p_table->_key_stride == sizeof(sg_u32));
+    sg_hash_table_insert_key(p_table, &key, p_value);
+}
+
+void sg_hash_table_insert_key(sg_hash_table* p_table, const void* p_key, void* p_value)
+{
+    void* p_val = sg_hash_table_emplace_key(p_table, p_key);
+    memcpy_s(p_val, p_table->_stride, p_value, p_table->_stride);
+}
+
+/*
+    1. Finish any migration and pre-size once for the whole batch
+    2. Hash a block of keys
+    3. Place each key while the start slots of the keys a few places ahead are being prefetched
+*/
+void sg_hash_table_insert_batch(sg_hash_table* p_table, const void* p_keys, const void* p_values, sg_u32 count)
+{
+    sg_hash_table_migrate(p_table, SG_HASH_TABLE_IDX_NULL);
+    sg_hash_table_reserve(p_table, p_table->_size + count + 1);
+
+    const sg_u8* p_key_bytes = (const sg_u8*)p_keys;
+    const sg_u8* p_val_bytes = (const sg_u8*)p_values;
+    sg_u32 hashes[SG_HASH_TABLE_BATCH_BLOCK];
+
+    sg_u32 block = 0;
+    while (block < count)
     {
-        if (p_table->_keys[idx] == SG_HASH_TABLE_KEY_NULL)
+        sg_u32 block_count = count - block;
+        if (block_count > SG_HASH_TABLE_BATCH_BLOCK)
+            block_count = SG_HASH_TABLE_BATCH_BLOCK;
+
+        sg_u32 i = 0;
+        while (i < block_count)
+        {
+            hashes[i] = sg_hash_key(p_table, p_key_bytes + (block + i) * p_table->_key_stride);
+            if (i < SG_HASH_TABLE_PREFETCH_DISTANCE)
+                sg_prefetch_slot(p_table, hashes[i], 1);
+
+            i += 1;
+        }
+
+        i = 0;
+        while (i < block_count)
         {
-            p_table->_keys[idx] = key;
-            p_table->_size += 1;
-            if (p_table->_probe_length < probe)
-                p_table->_probe_length = probe;
+            if (i + SG_HASH_TABLE_PREFETCH_DISTANCE < block_count)
+                sg_prefetch_slot(p_table, hashes[i + SG_HASH_TABLE_PREFETCH_DISTANCE], 1);
 
-            return p_table->_data + idx * p_table->_stride;
+            sg_u32 idx = sg_emplace(p_table, hashes[i], p_key_bytes + (block + i) * p_table->_key_stride);
+            memcpy_s(p_table->_data + idx * p_table->_stride, p_table->_stride, p_val_bytes + (block + i) * p_table->_stride, p_table->_stride);
+            i += 1;
         }
 
-        idx = (idx + 1) % p_table->_capacity;
-        probe += 1;
+        block += block_count;
     }
 }
 
-void sg_hash_table_insert(sg_hash_table* p_table, sg_u32 key, void* p_value)
+sg_u32 sg_hash_table_find_batch(sg_hash_table* p_table, const void* p_keys, sg_u32 count, void** pp_values)
 {
-    void* p_val = sg_hash_table_emplace(p_table, key);
-    memcpy_s(p_val, p_table->_stride, p_value, p_table->_stride);
-}
+    const sg_u8* p_key_bytes = (const sg_u8*)p_keys;
+    sg_u32 hashes[SG_HASH_TABLE_BATCH_BLOCK];
+    sg_u32 found = 0;
 
-void sg_hash_table_remove_at_index(sg_hash_table* p_table, sg_u32 idx)
-{
-    SG_ASSERT(idx < p_table->_capacity);
-    if (p_table->_keys[idx] != SG_HASH_TABLE_KEY_NULL)
+    sg_u32 block = 0;
+    while (block < count)
     {
-        sg_erase_key(p_table->_keys, idx);
-        sg_erase_val(p_table->_data, idx, p_table->_stride);
-        p_table->_size -= 1;
+        sg_u32 block_count = count - block;
+        if (block_count > SG_HASH_TABLE_BATCH_BLOCK)
+            block_count = SG_HASH_TABLE_BATCH_BLOCK;
+
+        sg_u32 i = 0;
+        while (i < block_count)
+        {
+            hashes[i] = sg_hash_key(p_table, p_key_bytes + (block + i) * p_table->_key_stride);
+            if (i < SG_HASH_TABLE_PREFETCH_DISTANCE)
+                sg_prefetch_slot(p_table, hashes[i], 0);
 
-        idx = (idx + 1) % p_table->_capacity;
+            i += 1;
+        }
 
-        while (p_table->_keys[idx] != SG_HASH_TABLE_KEY_NULL)
+        i = 0;
+        while (i < block_count)
         {
-            sg_u32 key = p_table->_keys[idx];
-            sg_u8* p_val = p_table->_data + idx * p_table->_stride;
-            sg_u8* p_temp = p_table->_data + p_table->_capacity * p_table->_stride;
-            memcpy_s(p_temp, p_table->_stride, p_val, p_table->_stride);
+            if (i + SG_HASH_TABLE_PREFETCH_DISTANCE < block_count)
+                sg_prefetch_slot(p_table, hashes[i + SG_HASH_TABLE_PREFETCH_DISTANCE], 0);
 
-            sg_erase_key(p_table->_keys, idx);
-            sg_erase_val(p_table->_data, idx, p_table->_stride);
-            p_table->_size -= 1;
+            // An in flight migration takes the regular path so hits in the previous arrays are pulled across
+            const sg_u8* p_key = p_key_bytes + (block + i) * p_table->_key_stride;
+            sg_u32 idx = SG_HASH_TABLE_IDX_NULL;
+            sg_u8 hit = p_table->_prev_ctrl ? sg_find(p_table, p_key, &idx) : sg_search(p_table, hashes[i], p_key, &idx);
 
-            sg_hash_table_insert(p_table, key, p_temp);
+            if (pp_values)
+                pp_values[block + i] = hit ? p_table->_data + idx * p_table->_stride : NULL;
 
-            idx = (idx + 1) % p_table->_capacity;
+            found += hit;
+            i += 1;
         }
 
-        if (p_table->_size == 0)
-            p_table->_probe_length = 0;
+        block += block_count;
+    }
+
+    return found;
+}
+
+void sg_hash_table_remove_at_index(sg_hash_table* p_table, sg_u32 idx)
+{
+    SG_ASSERT(idx < p_table->_capacity);
+    if (p_table->_ctrl[idx] != SG_HASH_TABLE_CTRL_EMPTY)
+    {
+        /*
+            1. Shift every following entry that is away from its start slot back by one
+            2. Stop at the first empty slot or entry already in its start slot
+            3. Erase the last slot that was vacated
+        */
+        sg_u32 idx_next = sg_idx_wrap(idx + 1, p_table->_capacity);
+        while (p_table->_dist[idx_next] != SG_HASH_TABLE_DIST_EMPTY && p_table->_dist[idx_next] != 0)
+        {
+            sg_move_slot(p_table, idx, idx_next, p_table->_dist[idx_next] - 1);
+            idx = idx_next;
+            idx_next = sg_idx_wrap(idx_next + 1, p_table->_capacity);
+        }
+
+        sg_erase_key(p_table, idx);
+        sg_erase_val(p_table->_data, idx, p_table->_stride);
+        p_table->_size -= 1;
     }
 }
 
 void sg_hash_table_remove(sg_hash_table* p_table, sg_u32 key)
+{
+    SG_ASSERT(p_table->_key_stride == sizeof(sg_u32));
+    sg_hash_table_remove_key(p_table, &key);
+}
+
+void sg_hash_table_remove_key(sg_hash_table* p_table, const void* p_key)
 {
     sg_u32 idx = SG_HASH_TABLE_IDX_NULL;
-    sg_u8 found = sg_search(p_table->_keys, key, p_table->_capacity, p_table->_probe_length, &idx);
+    sg_u8 found = sg_find(p_table, p_key, &idx);
     if (found)
     {
         sg_hash_table_remove_at_index(p_table, idx);
@@ -291,8 +831,85 @@ void sg_hash_table_remove(sg_hash_table* p_table, sg_u32 key)
 
 void sg_hash_table_clear(sg_hash_table* p_table)
 {
-    memset(p_table->_keys, SG_HASH_TABLE_KEY_NULL, sizeof(sg_u32) * p_table->_capacity);
+    sg_hash_table_release_prev(p_table);
+
+    memset(p_table->_ctrl, SG_HASH_TABLE_CTRL_EMPTY, p_table->_capacity + SG_HASH_TABLE_GROUP_WIDTH);
+    memset(p_table->_dist, SG_HASH_TABLE_DIST_EMPTY, p_table->_capacity + SG_HASH_TABLE_GROUP_WIDTH);
+    memset(p_table->_keys, SG_HASH_TABLE_KEY_NULL, p_table->_key_stride * p_table->_capacity);
     memset(p_table->_data, SG_HASH_TABLE_VAL_NULL, p_table->_stride * p_table->_capacity);
     p_table->_size = 0;
-    p_table->_probe_length = 0;
+}
+
+sg_u8 sg_hash_table_save(sg_hash_table* p_table, const char* path)
+{
+    // A resize in flight is finished so only the current arrays need saving
+    sg_hash_table_migrate(p_table, SG_HASH_TABLE_IDX_NULL);
+
+    sg_u64 ctrl_data_length = (sg_u64)p_table->_capacity + SG_HASH_TABLE_GROUP_WIDTH;
+    sg_u64 key_data_length = (sg_u64)p_table->_capacity * p_table->_key_stride;
+    sg_u64 val_data_length = (sg_u64)p_table->_capacity * p_table->_stride;
+
+    sg_snapshot_header header;
+    memset(&header, 0, sizeof(sg_snapshot_header));
+    header.kind = SG_SNAPSHOT_KIND_HASH_TABLE;
+    header.params[0] = p_table->_capacity;
+    header.params[1] = p_table->_size;
+    header.params[2] = p_table->_key_stride;
+    header.params[3] = p_table->_stride;
+    header.params[4] = p_table->_hash_shift;
+    memcpy(&header.params[5], &p_table->_load_factor, sizeof(sg_f32));
+    header.params[6] = (p_table->_hash ? 1U : 0U) | (p_table->_equal ? 2U : 0U);
+
+    const void* parts[4] = { p_table->_ctrl, p_table->_dist, p_table->_keys, p_table->_data };
+    sg_u64 sizes[4] = { ctrl_data_length, ctrl_data_length, key_data_length, val_data_length };
+    return sg_snapshot_save(path, &header, parts, sizes, 4);
+}
+
+sg_u8 sg_hash_table_load(sg_hash_table* p_table, const char* path, sg_hash_table_hash_fn p_hash, sg_hash_table_equal_fn p_equal, sg_allocator* p_allocator)
+{
+    sg_snapshot_reader reader;
+    sg_snapshot_header header;
+    if (!sg_snapshot_open(&reader, path, SG_SNAPSHOT_KIND_HASH_TABLE, &header))
+        return 0;
+
+    /* 1. Slots were placed by the saved hash so the callbacks have to be the same ones
+       2. The checksum is only known once the payload is read, so check the params used to allocate and index first */
+    sg_u32 flags = (p_hash ? 1U : 0U) | (p_equal ? 2U : 0U);
+    sg_u32 capacity = header.params[0];
+    sg_u64 ctrl_data_length = (sg_u64)capacity + SG_HASH_TABLE_GROUP_WIDTH;
+    sg_u64 payload_size = ctrl_data_length * 2 + (sg_u64)capacity * header.params[2] + (sg_u64)capacity * header.params[3];
+    if (header.params[6] != flags ||
+        capacity < s_minimum_capacity ||
+        header.params[1] > capacity ||
+        header.params[2] == 0 ||
+        header.params[4] >= 32 ||
+        payload_size != header.payload_size)
+    {
+        sg_snapshot_close(&reader, &header);
+        return 0;
+    }
+
+    sg_f32 load_factor = 0.0f;
+    memcpy(&load_factor, &header.params[5], sizeof(sg_f32));
+
+    sg_hash_table table = sg_hash_table_create_ext(0, header.params[2], header.params[3], load_factor, p_hash, p_equal, p_allocator);
+    sg_hash_table_free_slots(&table, table._ctrl, table._dist, table._keys, table._data);
+    sg_hash_table_alloc_slots_uninitialized(&table, capacity);
+    table._size = header.params[1];
+    table._hash_shift = header.params[4];
+
+    sg_u8 loaded =
+        sg_snapshot_read(&reader, table._ctrl, ctrl_data_length) &&
+        sg_snapshot_read(&reader, table._dist, ctrl_data_length) &&
+        sg_snapshot_read(&reader, table._keys, (sg_u64)capacity * table._key_stride) &&
+        sg_snapshot_read(&reader, table._data, (sg_u64)capacity * table._stride);
+
+    if (!sg_snapshot_close(&reader, &header) || !loaded)
+    {
+        sg_hash_table_destroy(&table);
+        return 0;
+    }
+
+    *p_table = table;
+    return 1;
 }
@@ -0,0 +1,389 @@
+#include "sg_parallel.h"
+#include "sg_allocator.h"
+#include "sg_assert.h"
+#include <string.h>
+
+#define SG_PARALLEL_FOR_EACH 0U
+#define SG_PARALLEL_TRANSFORM 1U
+#define SG_PARALLEL_REDUCE 2U
+
+static const sg_u32 s_chunks_per_worker = 8;
+static const sg_u32 s_spin_count = 64;
+
+typedef struct sg_parallel_job
+{
+    sg_u32 kind;
+    sg_slice input;
+    sg_slice output;
+    void* p_fn;
+    void* p_user_data;
+    sg_u8* p_accumulators;
+    sg_u32 accumulator_stride;
+    sg_u32 grain;
+    sg_u32 remaining;
+} sg_parallel_job;
+
+static sg_u8 sg_deque_push(sg_parallel_deque* p_deque, sg_parallel_range range)
+{
+    sg_u8 pushed = 0;
+    sg_spinlock_lock(&p_deque->_lock);
+    if (p_deque->_bottom - p_deque->_top < SG_PARALLEL_DEQUE_CAPACITY)
+    {
+        p_deque->_ranges[p_deque->_bottom % SG_PARALLEL_DEQUE_CAPACITY] = range;
+        sg_atomic_store_u32(&p_deque->_bottom, p_deque->_bottom + 1);
+        pushed = 1;
+    }
+    sg_spinlock_unlock(&p_deque->_lock);
+
+    return pushed;
+}
+
+static sg_u8 sg_deque_pop(sg_parallel_deque* p_deque, sg_parallel_range* p_range)
+{
+    sg_u8 popped = 0;
+    sg_spinlock_lock(&p_deque->_lock);
+    if (p_deque->_bottom != p_deque->_top)
+    {
+        sg_atomic_store_u32(&p_deque->_bottom, p_deque->_bottom - 1);
+        *p_range = p_deque->_ranges[p_deque->_bottom % SG_PARALLEL_DEQUE_CAPACITY];
+        popped = 1;
+    }
+    sg_spinlock_unlock(&p_deque->_lock);
+
+    return popped;
+}
+
+static sg_u8 sg_deque_steal(sg_parallel_deque* p_deque, sg_parallel_range* p_range)
+{
+    // Skip the lock when there is obviously nothing to take, the ends are stored atomically for this peek
+    if (sg_atomic_load_u32(&p_deque->_bottom) == sg_atomic_load_u32(&p_deque->_top))
+        return 0;
+
+    sg_u8 stolen = 0;
+    sg_spinlock_lock(&p_deque->_lock);
+    if (p_deque->_bottom != p_deque->_top)
+    {
+        *p_range = p_deque->_ranges[p_deque->_top % SG_PARALLEL_DEQUE_CAPACITY];
+        sg_atomic_store_u32(&p_deque->_top, p_deque->_top + 1);
+        stolen = 1;
+    }
+    sg_spinlock_unlock(&p_deque->_lock);
+
+    return stolen;
+}
+
+static void sg_parallel_run_range(sg_parallel_job* p_job, sg_u32 worker, sg_parallel_range range)
+{
+    sg_slice chunk = sg_slice_to_slice(&p_job->input, range.begin, range.end - range.begin);
+    if (p_job->kind == SG_PARALLEL_FOR_EACH)
+    {
+        ((sg_parallel_for_each_fn)p_job->p_fn)(&chunk, range.begin, p_job->p_user_data);
+    }
+    else if (p_job->kind == SG_PARALLEL_TRANSFORM)
+    {
+        sg_slice output = sg_slice_to_slice(&p_job->output, range.begin, range.end - range.begin);
+        ((sg_parallel_transform_fn)p_job->p_fn)(&chunk, &output, range.begin, p_job->p_user_data);
+    }
+    else
+    {
+        void* p_accumulator = p_job->p_accumulators + (sg_u64)worker * p_job->accumulator_stride;
+        ((sg_parallel_reduce_fn)p_job->p_fn)(&chunk, p_accumulator, p_job->p_user_data);
+    }
+}
+
+static void sg_parallel_work(sg_parallel_pool* p_pool, sg_parallel_job* p_job, sg_u32 worker)
+{
+    sg_parallel_deque* p_own = p_pool->_deques + worker;
+    sg_u32 spin = 0;
+    while (sg_atomic_load_u32(&p_job->remaining) != 0)
+    {
+        /* 1. Take from the bottom of the own deque, else steal from the top of another
+           2. Split the range in halves down to the grain, leaving the upper halves to be stolen
+           3. Run what is left and count it off */
+        sg_parallel_range range;
+        sg_u8 found = sg_deque_pop(p_own, &range);
+
+        sg_u32 i = 1;
+        while (!found && i < p_pool->_worker_count)
+        {
+            found = sg_deque_steal(p_pool->_deques + (worker + i) % p_pool->_worker_count, &range);
+            i += 1;
+        }
+
+        if (!found)
+        {
+            if (spin < s_spin_count)
+            {
+                SG_ATOMIC_PAUSE();
+                spin += 1;
+            }
+            else
+            {
+                sg_thread_yield();
+            }
+
+            continue;
+        }
+
+        spin = 0;
+        while (range.end - range.begin > p_job->grain)
+        {
+            sg_u32 middle = range.begin + (range.end - range.begin) / 2;
+            sg_parallel_range upper = { middle, range.end };
+            if (!sg_deque_push(p_own, upper))
+                break;
+
+            range.end = middle;
+        }
+
+        sg_parallel_run_range(p_job, worker, range);
+        sg_atomic_fetch_add_u32(&p_job->remaining, 0U - (range.end - range.begin));
+    }
+}
+
+static void sg_parallel_worker_main(void* p_user_data)
+{
+    sg_parallel_worker* p_worker = (sg_parallel_worker*)p_user_data;
+    sg_parallel_pool* p_pool = p_worker->p_pool;
+    sg_u32 generation = 0;
+
+    while (1)
+    {
+        // Joining under the mutex while the job is set keeps the caller waiting until this worker lets go of it
+        sg_mutex_lock(&p_pool->_mutex);
+        while (!p_pool->_stop && (p_pool->_generation == generation || p_pool->_job == NULL))
+        {
+            generation = p_pool->_generation;
+            sg_condition_wait(&p_pool->_condition, &p_pool->_mutex);
+        }
+
+        if (p_pool->_stop)
+        {
+            sg_mutex_unlock(&p_pool->_mutex);
+            return;
+        }
+
+        generation = p_pool->_generation;
+        sg_parallel_job* p_job = (sg_parallel_job*)p_pool->_job;
+        sg_atomic_fetch_add_u32(&p_pool->_active, 1);
+        sg_mutex_unlock(&p_pool->_mutex);
+
+        sg_parallel_work(p_pool, p_job, p_worker->_index);
+        sg_atomic_fetch_add_u32(&p_pool->_active, 0U - 1U);
+    }
+}
+
+static void sg_parallel_pool_start(sg_parallel_pool* p_pool)
+{
+    sg_allocator* p_allocator = p_pool->p_allocator;
+    p_pool->_threads = (sg_thread*)p_allocator->allocate(sizeof(sg_thread) * p_pool->_worker_count, p_allocator->p_user_data);
+    p_pool->_workers = (sg_parallel_worker*)p_allocator->allocate(sizeof(sg_parallel_worker) * p_pool->_worker_count, p_allocator->p_user_data);
+
+    // Worker 0 is whichever thread submits the job
+    sg_u32 i = 1;
+    while (i < p_pool->_worker_count)
+    {
+        p_pool->_workers[i].p_pool = p_pool;
+        p_pool->_workers[i]._index = i;
+        sg_u8 started = sg_thread_create(p_pool->_threads + i, &sg_parallel_worker_main, p_pool->_workers + i);
+        SG_ASSERT(started);
+        i += 1;
+    }
+}
+
+static void sg_parallel_run(sg_parallel_pool* p_pool, sg_parallel_job* p_job)
+{
+    if (p_job->input._count == 0)
+        return;
+
+    // Without a pool, or with a single chunk, there is nothing to share
+    if (p_pool == NULL || p_pool->_worker_count == 1 || p_job->input._count <= p_job->grain)
+    {
+        sg_parallel_range range = { 0, p_job->input._count };
+        sg_parallel_run_range(p_job, 0, range);
+        return;
+    }
+
+    sg_spinlock_lock(&p_pool->_submit);
+
+    // Workers keep a pointer to the pool so they start once it has settled at its address
+    if (p_pool->_threads == NULL)
+        sg_parallel_pool_start(p_pool);
+
+    p_job->remaining = p_job->input._count;
+    sg_parallel_range range = { 0, p_job->input._count };
+    sg_u8 pushed = sg_deque_push(p_pool->_deques, range);
+    SG_ASSERT(pushed);
+
+    sg_mutex_lock(&p_pool->_mutex);
+    p_pool->_job = p_job;
+    p_pool->_generation += 1;
+    sg_condition_broadcast(&p_pool->_condition);
+    sg_mutex_unlock(&p_pool->_mutex);
+
+    sg_parallel_work(p_pool, p_job, 0);
+
+    /* 1. Stop new workers from joining
+       2. Wait for the ones that joined to finish with the job */
+    sg_mutex_lock(&p_pool->_mutex);
+    p_pool->_job = NULL;
+    sg_mutex_unlock(&p_pool->_mutex);
+
+    sg_u32 spin = 0;
+    while (sg_atomic_load_u32(&p_pool->_active) != 0)
+    {
+        if (spin < s_spin_count)
+        {
+            SG_ATOMIC_PAUSE();
+            spin += 1;
+        }
+        else
+        {
+            sg_thread_yield();
+        }
+    }
+
+    sg_spinlock_unlock(&p_pool->_submit);
+}
+
+sg_parallel_pool sg_parallel_pool_create(sg_u32 worker_count, sg_allocator* p_allocator)
+{
+    if (p_allocator == NULL)
+        p_allocator = &s_allocator_default;
+
+    if (worker_count == 0)
+        worker_count = sg_thread_hardware_concurrency();
+
+    sg_parallel_pool pool;
+    memset(&pool, 0, sizeof(sg_parallel_pool));
+    pool.p_allocator = p_allocator;
+    pool._worker_count = worker_count;
+    pool._deques = (sg_parallel_deque*)sg_allocator_allocate_aligned(p_allocator, sizeof(sg_parallel_deque) * worker_count, SG_PARALLEL_CACHE_LINE);
+    memset(pool._deques, 0, sizeof(sg_parallel_deque) * worker_count);
+
+    sg_mutex_init(&pool._mutex);
+    sg_condition_init(&pool._condition);
+    return pool;
+}
+
+void sg_parallel_pool_destroy(sg_parallel_pool* p_pool)
+{
+    if (p_pool->_threads)
+    {
+        sg_mutex_lock(&p_pool->_mutex);
+        p_pool->_stop = 1;
+        sg_condition_broadcast(&p_pool->_condition);
+        sg_mutex_unlock(&p_pool->_mutex);
+
+        sg_u32 i = 1;
+        while (i < p_pool->_worker_count)
+        {
+            sg_thread_join(p_pool->_threads + i);
+            i += 1;
+        }
+
+        p_pool->p_allocator->free(p_pool->_threads, p_pool->p_allocator->p_user_data);
+        p_pool->p_allocator->free(p_pool->_workers, p_pool->p_allocator->p_user_data);
+    }
+
+    if (p_pool->_deques)
+        sg_allocator_free_aligned(p_pool->p_allocator, p_pool->_deques);
+
+    sg_condition_destroy(&p_pool->_condition);
+    sg_mutex_destroy(&p_pool->_mutex);
+    memset(p_pool, 0, sizeof(sg_parallel_pool));
+}
+
+sg_u32 sg_parallel_grain(sg_slice* p_slice, sg_u32 worker_count)
+{
+    sg_u32 stride = p_slice->_stride ? p_slice->_stride : 1;
+    sg_u32 grain = SG_PARALLEL_GRAIN_BYTES / stride;
+
+    // Small slices still get a few chunks per worker so stealing can even out the load
+    sg_u64 chunks = (sg_u64)worker_count * s_chunks_per_worker;
+    sg_u32 balanced = (sg_u32)(((sg_u64)p_slice->_count + chunks - 1) / chunks);
+    if (balanced < grain)
+        grain = balanced;
+
+    return grain ? grain : 1;
+}
+
+static inline sg_u32 sg_parallel_job_grain(sg_parallel_pool* p_pool, sg_slice* p_slice, sg_u32 grain)
+{
+    if (grain)
+        return grain;
+
+    return sg_parallel_grain(p_slice, p_pool ? p_pool->_worker_count : 1);
+}
+
+void sg_parallel_for_each(sg_parallel_pool* p_pool, sg_slice* p_slice, sg_u32 grain, sg_parallel_for_each_fn p_fn, void* p_user_data)
+{
+    sg_parallel_job job;
+    memset(&job, 0, sizeof(sg_parallel_job));
+    job.kind = SG_PARALLEL_FOR_EACH;
+    job.input = *p_slice;
+    job.p_fn = (void*)p_fn;
+    job.p_user_data = p_user_data;
+    job.grain = sg_parallel_job_grain(p_pool, p_slice, grain);
+    sg_parallel_run(p_pool, &job);
+}
+
+void sg_parallel_transform(sg_parallel_pool* p_pool, sg_slice* p_input, sg_slice* p_output, sg_u32 grain, sg_parallel_transform_fn p_fn, void* p_user_data)
+{
+    SG_ASSERT(p_input->_count == p_output->_count);
+
+    sg_parallel_job job;
+    memset(&job, 0, sizeof(sg_parallel_job));
+    job.kind = SG_PARALLEL_TRANSFORM;
+    job.input = *p_input;
+    job.output = *p_output;
+    job.p_fn = (void*)p_fn;
+    job.p_user_data = p_user_data;
+    job.grain = sg_parallel_job_grain(p_pool, p_input, grain);
+    sg_parallel_run(p_pool, &job);
+}
+
+void sg_parallel_reduce(sg_parallel_pool* p_pool, sg_slice* p_slice, sg_u32 grain, void* p_result, sg_u32 result_size, sg_parallel_reduce_fn p_reduce, sg_parallel_combine_fn p_combine, void* p_user_data)
+{
+    sg_parallel_job job;
+    memset(&job, 0, sizeof(sg_parallel_job));
+    job.kind = SG_PARALLEL_REDUCE;
+    job.input = *p_slice;
+    job.p_fn = (void*)p_reduce;
+    job.p_user_data = p_user_data;
+    job.grain = sg_parallel_job_grain(p_pool, p_slice, grain);
+
+    // Without workers everything folds straight into the result
+    if (p_pool == NULL || p_pool->_worker_count == 1 || p_slice->_count <= job.grain)
+    {
+        job.p_accumulators = (sg_u8*)p_result;
+        sg_parallel_run(p_pool, &job);
+        return;
+    }
+
+    /* 1. Give every worker a copy of the identity on its own cache lines
+       2. Run the job
+       3. Combine the copies into the result in worker order */
+    sg_allocator* p_allocator = p_pool->p_allocator;
+    sg_u32 accumulator_stride = (result_size + SG_PARALLEL_CACHE_LINE - 1) & ~(SG_PARALLEL_CACHE_LINE - 1);
+    job.accumulator_stride = accumulator_stride;
+    job.p_accumulators = (sg_u8*)sg_allocator_allocate_aligned(p_allocator, (sg_u64)accumulator_stride * p_pool->_worker_count, SG_PARALLEL_CACHE_LINE);
+
+    sg_u32 i = 0;
+    while (i < p_pool->_worker_count)
+    {
+        memcpy_s(job.p_accumulators + (sg_u64)i * accumulator_stride, accumulator_stride, p_result, result_size);
+        i += 1;
+    }
+
+    sg_parallel_run(p_pool, &job);
+
+    i = 0;
+    while (i < p_pool->_worker_count)
+    {
+        p_combine(p_result, job.p_accumulators + (sg_u64)i * accumulator_stride, p_user_data);
+        i += 1;
+    }
+
+    sg_allocator_free_aligned(p_allocator, job.p_accumulators);
+}
@@ -0,0 +1,253 @@
+#include "sg_pool_allocator.h"
+#include "sg_allocator.h"
+#include "sg_assert.h"
+#include <string.h>
+
+static inline sg_u64 sg_block_size(sg_u32 class_idx)
+{
+    return (sg_u64)SG_POOL_ALLOCATOR_MIN_BLOCK << class_idx;
+}
+
+static inline sg_u32 sg_class_index(sg_u64 size)
+{
+    sg_u32 class_idx = 0;
+    while (class_idx < SG_POOL_ALLOCATOR_CLASS_COUNT && sg_block_size(class_idx) < size)
+        class_idx += 1;
+
+    return class_idx;
+}
+
+static inline sg_u64* sg_header(void* p_allocation)
+{
+    return (sg_u64*)((sg_u8*)p_allocation - SG_POOL_ALLOCATOR_HEADER);
+}
+
+static inline sg_pool_large* sg_large(void* p_allocation)
+{
+    return (sg_pool_large*)((sg_u8*)p_allocation - SG_POOL_ALLOCATOR_HEADER - SG_POOL_ALLOCATOR_LARGE_HEADER);
+}
+
+// Links a block from the parent into the large list and returns where its header goes
+static sg_u8* sg_pool_large_link(sg_pool_allocator* p_pool, sg_pool_large* p_large)
+{
+    p_large->_prev = NULL;
+    p_large->_next = p_pool->_large;
+    if (p_pool->_large)
+        p_pool->_large->_prev = p_large;
+
+    p_pool->_large = p_large;
+    return (sg_u8*)p_large + SG_POOL_ALLOCATOR_LARGE_HEADER;
+}
+
+static void sg_pool_large_unlink(sg_pool_allocator* p_pool, sg_pool_large* p_large)
+{
+    if (p_large->_prev)
+        p_large->_prev->_next = p_large->_next;
+    else
+        p_pool->_large = p_large->_next;
+
+    if (p_large->_next)
+        p_large->_next->_prev = p_large->_prev;
+}
+
+static void* sg_pool_allocator_allocate_fn(sg_u64 size, void* p_user_data)
+{
+    return sg_pool_allocator_allocate((sg_pool_allocator*)p_user_data, size);
+}
+
+static void sg_pool_allocator_free_fn(void* p_allocation, void* p_user_data)
+{
+    sg_pool_allocator_free((sg_pool_allocator*)p_user_data, p_allocation);
+}
+
+static void* sg_pool_allocator_realloc_fn(void* p_allocation, sg_u64 size, void* p_user_data)
+{
+    return sg_pool_allocator_realloc((sg_pool_allocator*)p_user_data, p_allocation, size);
+}
+
+static void sg_pool_allocator_push_slab(sg_pool_allocator* p_pool, sg_pool_class* p_class, sg_u64 stride)
+{
+    // Slabs hold at least one block of the class
+    sg_u64 slab_size = p_pool->_slab_size;
+    if (slab_size < stride)
+        slab_size = stride;
+
+    sg_allocator* p_parent = p_pool->p_parent;
+    sg_u8* p_slab = (sg_u8*)p_parent->allocate(SG_POOL_ALLOCATOR_HEADER + slab_size, p_parent->p_user_data);
+    ((sg_pool_slab*)p_slab)->_next = p_pool->_slabs;
+    p_pool->_slabs = (sg_pool_slab*)p_slab;
+
+    p_class->_cursor = p_slab + SG_POOL_ALLOCATOR_HEADER;
+    p_class->_end = p_class->_cursor + (slab_size / stride) * stride;
+}
+
+sg_pool_allocator sg_pool_allocator_create(sg_u64 slab_size, sg_allocator* p_parent)
+{
+    if (p_parent == NULL)
+        p_parent = &s_allocator_default;
+
+    if (slab_size == 0)
+        slab_size = SG_POOL_ALLOCATOR_SLAB_SIZE;
+
+    sg_pool_allocator pool;
+    pool.p_parent = p_parent;
+    pool._slabs = NULL;
+    pool._large = NULL;
+    pool._slab_size = slab_size;
+
+    sg_u32 i = 0;
+    while (i < SG_POOL_ALLOCATOR_CLASS_COUNT)
+    {
+        pool._classes[i]._free = NULL;
+        pool._classes[i]._cursor = NULL;
+        pool._classes[i]._end = NULL;
+        i += 1;
+    }
+
+    return pool;
+}
+
+void sg_pool_allocator_destroy(sg_pool_allocator* p_pool)
+{
+    sg_pool_slab* p_slab = p_pool->_slabs;
+    while (p_slab)
+    {
+        sg_pool_slab* p_next = p_slab->_next;
+        p_pool->p_parent->free(p_slab, p_pool->p_parent->p_user_data);
+        p_slab = p_next;
+    }
+
+    sg_pool_large* p_large = p_pool->_large;
+    while (p_large)
+    {
+        sg_pool_large* p_next = p_large->_next;
+        p_pool->p_parent->free(p_large, p_pool->p_parent->p_user_data);
+        p_large = p_next;
+    }
+
+    p_pool->p_parent = NULL;
+    p_pool->_slabs = NULL;
+    p_pool->_large = NULL;
+    p_pool->_slab_size = 0;
+
+    sg_u32 i = 0;
+    while (i < SG_POOL_ALLOCATOR_CLASS_COUNT)
+    {
+        p_pool->_classes[i]._free = NULL;
+        p_pool->_classes[i]._cursor = NULL;
+        p_pool->_classes[i]._end = NULL;
+        i += 1;
+    }
+}
+
+sg_allocator sg_pool_allocator_allocator(sg_pool_allocator* p_pool)
+{
+    sg_allocator allocator =
+    {
+        &sg_pool_allocator_allocate_fn,
+        &sg_pool_allocator_free_fn,
+        &sg_pool_allocator_realloc_fn,
+        p_pool,
+        NULL,
+        NULL,
+        NULL
+    };
+
+    return allocator;
+}
+
+void* sg_pool_allocator_allocate(sg_pool_allocator* p_pool, sg_u64 size)
+{
+    sg_u32 class_idx = sg_class_index(size);
+    sg_u8* p_block = NULL;
+
+    /* 1. Oversized requests go to the parent with the same header, linked into the large list
+       2. Pop the free list
+       3. Carve the next block from the class slab, taking a new slab when it runs out */
+    if (class_idx == SG_POOL_ALLOCATOR_CLASS_COUNT)
+    {
+        sg_allocator* p_parent = p_pool->p_parent;
+        sg_pool_large* p_large = (sg_pool_large*)p_parent->allocate(SG_POOL_ALLOCATOR_LARGE_HEADER + SG_POOL_ALLOCATOR_HEADER + size, p_parent->p_user_data);
+        p_block = sg_pool_large_link(p_pool, p_large);
+    }
+    else
+    {
+        sg_pool_class* p_class = p_pool->_classes + class_idx;
+        if (p_class->_free)
+        {
+            p_block = (sg_u8*)p_class->_free - SG_POOL_ALLOCATOR_HEADER;
+            p_class->_free = *(void**)p_class->_free;
+        }
+        else
+        {
+            sg_u64 stride = SG_POOL_ALLOCATOR_HEADER + sg_block_size(class_idx);
+            if (p_class->_cursor == p_class->_end)
+                sg_pool_allocator_push_slab(p_pool, p_class, stride);
+
+            p_block = p_class->_cursor;
+            p_class->_cursor += stride;
+        }
+    }
+
+    *(sg_u64*)p_block = size;
+    return p_block + SG_POOL_ALLOCATOR_HEADER;
+}
+
+void sg_pool_allocator_free(sg_pool_allocator* p_pool, void* p_allocation)
+{
+    if (p_allocation == NULL)
+        return;
+
+    sg_u32 class_idx = sg_class_index(*sg_header(p_allocation));
+    if (class_idx == SG_POOL_ALLOCATOR_CLASS_COUNT)
+    {
+        sg_pool_large* p_large = sg_large(p_allocation);
+        sg_pool_large_unlink(p_pool, p_large);
+        p_pool->p_parent->free(p_large, p_pool->p_parent->p_user_data);
+        return;
+    }
+
+    sg_pool_class* p_class = p_pool->_classes + class_idx;
+    *(void**)p_allocation = p_class->_free;
+    p_class->_free = p_allocation;
+}
+
+void* sg_pool_allocator_realloc(sg_pool_allocator* p_pool, void* p_allocation, sg_u64 size)
+{
+    if (p_allocation == NULL)
+        return sg_pool_allocator_allocate(p_pool, size);
+
+    /* 1. Blocks that stay in their class keep their address
+       2. Oversized blocks that stay oversized are resized by the parent
+       3. Anything else moves between classes */
+    sg_u64 old_size = *sg_header(p_allocation);
+    sg_u32 class_idx = sg_class_index(size);
+    if (class_idx == sg_class_index(old_size))
+    {
+        if (class_idx == SG_POOL_ALLOCATOR_CLASS_COUNT)
+        {
+            // The block may move so it leaves the list while the parent resizes it
+            sg_allocator* p_parent = p_pool->p_parent;
+            sg_pool_large* p_large = sg_large(p_allocation);
+            sg_pool_large_unlink(p_pool, p_large);
+            p_large = (sg_pool_large*)p_parent->realloc(p_large, SG_POOL_ALLOCATOR_LARGE_HEADER + SG_POOL_ALLOCATOR_HEADER + size, p_parent->p_user_data);
+            sg_u8* p_block = sg_pool_large_link(p_pool, p_large);
+            *(sg_u64*)p_block = size;
+            return p_block + SG_POOL_ALLOCATOR_HEADER;
+        }
+
+        *sg_header(p_allocation) = size;
+        return p_allocation;
+    }
+
+    void* p_reallocation = sg_pool_allocator_allocate(p_pool, size);
+    memcpy_s(p_reallocation, size, p_allocation, old_size < size ? old_size : size);
+    sg_pool_allocator_free(p_pool, p_allocation);
+
+    return p_reallocation;
+}
+
+sg_u64 sg_pool_allocator_max_block(void)
+{
+    return sg_block_size(SG_POOL_ALLOCATOR_CLASS_COUNT - 1);
+}
@@ -0,0 +1,794 @@
+#include "sg_slice.h"
+#include "sg_assert.h"
+#include "sg_cpu.h"
+#include <string.h>
+
+#if SG_CPU_X86
+#include <immintrin.h>
+#endif
+
+static inline sg_u32 sg_ctz(sg_u32 mask)
+{
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward(&idx, mask);
+    return (sg_u32)idx;
+#else
+    return (sg_u32)__builtin_ctz(mask);
+#endif
+}
+
+static inline sg_u32 sg_popcount(sg_u32 mask)
+{
+#if defined(_MSC_VER)
+    // __popcnt needs its own cpuid bit, count in registers instead
+    mask = mask - ((mask >> 1) & 0x55555555U);
+    mask = (mask & 0x33333333U) + ((mask >> 2) & 0x33333333U);
+    return (((mask + (mask >> 4)) & 0x0F0F0F0FU) * 0x01010101U) >> 24;
+#else
+    return (sg_u32)__builtin_popcount(mask);
+#endif
+}
+
+static inline sg_u64 sg_width_max(sg_u32 width)
+{
+    return width == sizeof(sg_u64) ? ~0ull : (1ull << (width * 8)) - 1;
+}
+
+static inline sg_u64 sg_load(const sg_u8* p_element, sg_u32 width)
+{
+    switch (width)
+    {
+    case 1: return *p_element;
+    case 2: { sg_u16 value; memcpy(&value, p_element, 2); return value; }
+    case 4: { sg_u32 value; memcpy(&value, p_element, 4); return value; }
+    default: { sg_u64 value; memcpy(&value, p_element, 8); return value; }
+    }
+}
+
+/* Scalar */
+
+static sg_u32 sg_find_range(const sg_u8* p_data, sg_u32 begin, sg_u32 count, sg_u64 value, sg_u32 width)
+{
+    sg_u32 i = begin;
+    while (i < count)
+    {
+        if (sg_load(p_data + (sg_u64)i * width, width) == value)
+            return i;
+
+        i += 1;
+    }
+
+    return SG_SLICE_IDX_NULL;
+}
+
+static sg_u32 sg_count_range(const sg_u8* p_data, sg_u32 begin, sg_u32 count, sg_u64 value, sg_u32 width)
+{
+    sg_u32 matches = 0;
+    sg_u32 i = begin;
+    while (i < count)
+    {
+        matches += sg_load(p_data + (sg_u64)i * width, width) == value;
+        i += 1;
+    }
+
+    return matches;
+}
+
+static void sg_min_max_range(const sg_u8* p_data, sg_u32 begin, sg_u32 count, sg_u32 width, sg_u64* p_min, sg_u64* p_max)
+{
+    sg_u32 i = begin;
+    while (i < count)
+    {
+        sg_u64 value = sg_load(p_data + (sg_u64)i * width, width);
+        if (value < *p_min) *p_min = value;
+        if (value > *p_max) *p_max = value;
+        i += 1;
+    }
+}
+
+static sg_u32 sg_find_scalar(const sg_u8* p_data, sg_u32 count, sg_u64 value, sg_u32 width)
+{
+    return sg_find_range(p_data, 0, count, value, width);
+}
+
+static sg_u32 sg_count_scalar(const sg_u8* p_data, sg_u32 count, sg_u64 value, sg_u32 width)
+{
+    return sg_count_range(p_data, 0, count, value, width);
+}
+
+static void sg_min_max_scalar(const sg_u8* p_data, sg_u32 count, sg_u32 width, sg_u64* p_min, sg_u64* p_max)
+{
+    sg_min_max_range(p_data, 0, count, width, p_min, p_max);
+}
+
+static void sg_fill_range(sg_u8* p_data, sg_u64 begin, sg_u64 end, sg_u32 stride, const sg_u8* p_value)
+{
+    if (stride == 1)
+    {
+        memset(p_data + begin, *p_value, (size_t)(end - begin));
+        return;
+    }
+
+    sg_u64 byte_offset = begin;
+    while (byte_offset < end)
+    {
+        memcpy(p_data + byte_offset, p_value, stride);
+        byte_offset += stride;
+    }
+}
+
+static void sg_fill_scalar(sg_u8* p_data, sg_u32 count, sg_u32 stride, const sg_u8* p_value)
+{
+    sg_fill_range(p_data, 0, (sg_u64)count * stride, stride, p_value);
+}
+
+static void sg_gather_range(const sg_u8* p_data, sg_u32 begin, sg_u32 count, sg_u32 stride, sg_u32 offset, sg_u32 size, sg_u8* p_output)
+{
+    // Fixed sizes become plain moves
+    const sg_u8* p_element = p_data + (sg_u64)begin * stride + offset;
+    sg_u8* p_packed = p_output + (sg_u64)begin * size;
+    sg_u32 i = begin;
+    switch (size)
+    {
+    case 4:
+        while (i < count) { memcpy(p_packed, p_element, 4); p_packed += 4; p_element += stride; i += 1; }
+        break;
+    case 8:
+        while (i < count) { memcpy(p_packed, p_element, 8); p_packed += 8; p_element += stride; i += 1; }
+        break;
+    default:
+        while (i < count) { memcpy(p_packed, p_element, size); p_packed += size; p_element += stride; i += 1; }
+        break;
+    }
+}
+
+static void sg_gather_scalar(const sg_u8* p_data, sg_u32 count, sg_u32 stride, sg_u32 offset, sg_u32 size, sg_u8* p_output)
+{
+    sg_gather_range(p_data, 0, count, stride, offset, size, p_output);
+}
+
+static sg_u8 sg_equal_scalar(const sg_u8* p_data_a, const sg_u8* p_data_b, sg_u64 size)
+{
+    return memcmp(p_data_a, p_data_b, (size_t)size) == 0;
+}
+
+#if SG_CPU_X86
+
+/* SSE2, 16 bytes at a time */
+
+SG_CPU_TARGET_SSE2 static inline __m128i sg_sse2_set1(sg_u64 value, sg_u32 width)
+{
+    switch (width)
+    {
+    case 1: return _mm_set1_epi8((char)value);
+    case 2: return _mm_set1_epi16((short)value);
+    case 4: return _mm_set1_epi32((int)value);
+    default: return _mm_set1_epi64x((long long)value);
+    }
+}
+
+SG_CPU_TARGET_SSE2 static inline __m128i sg_sse2_cmpeq(__m128i a, __m128i b, sg_u32 width)
+{
+    switch (width)
+    {
+    case 1: return _mm_cmpeq_epi8(a, b);
+    case 2: return _mm_cmpeq_epi16(a, b);
+    case 4: return _mm_cmpeq_epi32(a, b);
+    default:
+    {
+        // Both 32 bit halves have to match
+        __m128i eq = _mm_cmpeq_epi32(a, b);
+        return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+    }
+}
+
+SG_CPU_TARGET_SSE2 static inline sg_u32 sg_find_sse2_width(const sg_u8* p_data, sg_u32 count, sg_u64 value, sg_u32 width)
+{
+    __m128i needle = sg_sse2_set1(value, width);
+    sg_u32 lanes = 16 / width;
+    sg_u32 i = 0;
+    while (i + lanes <= count)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i*)(p_data + (sg_u64)i * width));
+        sg_u32 mask = (sg_u32)_mm_movemask_epi8(sg_sse2_cmpeq(block, needle, width));
+        if (mask)
+            return i + sg_ctz(mask) / width;
+
+        i += lanes;
+    }
+
+    return sg_find_range(p_data, i, count, value, width);
+}
+
+SG_CPU_TARGET_SSE2 static sg_u32 sg_find_sse2(const sg_u8* p_data, sg_u32 count, sg_u64 value, sg_u32 width)
+{
+    switch (width)
+    {
+    case 1: return sg_find_sse2_width(p_data, count, value, 1);
+    case 2: return sg_find_sse2_width(p_data, count, value, 2);
+    case 4: return sg_find_sse2_width(p_data, count, value, 4);
+    default: return sg_find_sse2_width(p_data, count, value, 8);
+    }
+}
+
+SG_CPU_TARGET_SSE2 static inline sg_u32 sg_count_sse2_width(const sg_u8* p_data, sg_u32 count, sg_u64 value, sg_u32 width)
+{
+    __m128i needle = sg_sse2_set1(value, width);
+    sg_u32 lanes = 16 / width;
+    sg_u64 matches = 0;
+    sg_u32 i = 0;
+    while (i + lanes <= count)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i*)(p_data + (sg_u64)i * width));
+        matches += sg_popcount((sg_u32)_mm_movemask_epi8(sg_sse2_cmpeq(block, needle, width)));
+        i += lanes;
+    }
+
+    // Every matching element set width mask bits
+    return (sg_u32)(matches / width) + sg_count_range(p_data, i, count, value, width);
+}
+
+SG_CPU_TARGET_SSE2 static sg_u32 sg_count_sse2(const sg_u8* p_data, sg_u32 count, sg_u64 value, sg_u32 width)
+{
+    switch (width)
+    {
+    case 1: return sg_count_sse2_width(p_data, count, value, 1);
+    case 2: return sg_count_sse2_width(p_data, count, value, 2);
+    case 4: return sg_count_sse2_width(p_data, count, value, 4);
+    default: return sg_count_sse2_width(p_data, count, value, 8);
+    }
+}
+
+SG_CPU_TARGET_SSE2 static inline void sg_min_max_sse2_width(const sg_u8* p_data, sg_u32 count, sg_u32 width, sg_u64* p_min, sg_u64* p_max)
+{
+    /* 1. Keep per lane minimums and maximums, SSE2 only compares signed 16 and 32 bit lanes
+          so those are biased by the sign bit on the way in and out
+       2. Fold the lanes and the tail */
+    sg_u32 lanes = 16 / width;
+    if (count < lanes)
+    {
+        sg_min_max_range(p_data, 0, count, width, p_min, p_max);
+        return;
+    }
+
+    __m128i bias = width == 2 ? _mm_set1_epi16((short)0x8000) : _mm_set1_epi32((int)0x80000000);
+    __m128i lo = _mm_loadu_si128((const __m128i*)p_data);
+    if (width != 1) lo = _mm_xor_si128(lo, bias);
+    __m128i hi = lo;
+
+    sg_u32 i = lanes;
+    while (i + lanes <= count)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i*)(p_data + (sg_u64)i * width));
+        if (width == 1)
+        {
+            lo = _mm_min_epu8(lo, block);
+            hi = _mm_max_epu8(hi, block);
+        }
+        else if (width == 2)
+        {
+            block = _mm_xor_si128(block, bias);
+            lo = _mm_min_epi16(lo, block);
+            hi = _mm_max_epi16(hi, block);
+        }
+        else
+        {
+            block = _mm_xor_si128(block, bias);
+            __m128i lo_greater = _mm_cmpgt_epi32(lo, block);
+            __m128i hi_greater = _mm_cmpgt_epi32(hi, block);
+            lo = _mm_or_si128(_mm_and_si128(lo_greater, block), _mm_andnot_si128(lo_greater, lo));
+            hi = _mm_or_si128(_mm_and_si128(hi_greater, hi), _mm_andnot_si128(hi_greater, block));
+        }
+
+        i += lanes;
+    }
+
+    if (width != 1)
+    {
+        lo = _mm_xor_si128(lo, bias);
+        hi = _mm_xor_si128(hi, bias);
+    }
+
+    sg_u8 lo_lanes[16];
+    sg_u8 hi_lanes[16];
+    _mm_storeu_si128((__m128i*)lo_lanes, lo);
+    _mm_storeu_si128((__m128i*)hi_lanes, hi);
+    sg_min_max_range(lo_lanes, 0, lanes, width, p_min, p_max);
+    sg_min_max_range(hi_lanes, 0, lanes, width, p_min, p_max);
+    sg_min_max_range(p_data, i, count, width, p_min, p_max);
+}
+
+SG_CPU_TARGET_SSE2 static void sg_min_max_sse2(const sg_u8* p_data, sg_u32 count, sg_u32 width, sg_u64* p_min, sg_u64* p_max)
+{
+    // No unsigned 64 bit compare before SSE4.2
+    switch (width)
+    {
+    case 1: sg_min_max_sse2_width(p_data, count, 1, p_min, p_max); break;
+    case 2: sg_min_max_sse2_width(p_data, count, 2, p_min, p_max); break;
+    case 4: sg_min_max_sse2_width(p_data, count, 4, p_min, p_max); break;
+    default: sg_min_max_range(p_data, 0, count, width, p_min, p_max); break;
+    }
+}
+
+SG_CPU_TARGET_SSE2 static void sg_fill_sse2(sg_u8* p_data, sg_u32 count, sg_u32 stride, const sg_u8* p_value)
+{
+    // Repeat the element across a register when it divides one evenly
+    if (16 % stride != 0)
+    {
+        sg_fill_scalar(p_data, count, stride, p_value);
+        return;
+    }
+
+    sg_u8 pattern[16];
+    sg_fill_range(pattern, 0, 16, stride, p_value);
+    __m128i block = _mm_loadu_si128((const __m128i*)pattern);
+
+    sg_u64 size = (sg_u64)count * stride;
+    sg_u64 byte_offset = 0;
+    while (byte_offset + 16 <= size)
+    {
+        _mm_storeu_si128((__m128i*)(p_data + byte_offset), block);
+        byte_offset += 16;
+    }
+
+    memcpy(p_data + byte_offset, pattern, (size_t)(size - byte_offset));
+}
+
+SG_CPU_TARGET_SSE2 static sg_u8 sg_equal_sse2(const sg_u8* p_data_a, const sg_u8* p_data_b, sg_u64 size)
+{
+    sg_u64 byte_offset = 0;
+    while (byte_offset + 16 <= size)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)(p_data_a + byte_offset));
+        __m128i b = _mm_loadu_si128((const __m128i*)(p_data_b + byte_offset));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) != 0xFFFF)
+            return 0;
+
+        byte_offset += 16;
+    }
+
+    return memcmp(p_data_a + byte_offset, p_data_b + byte_offset, (size_t)(size - byte_offset)) == 0;
+}
+
+/* AVX2, 32 bytes at a time */
+
+SG_CPU_TARGET_AVX2 static inline __m256i sg_avx2_set1(sg_u64 value, sg_u32 width)
+{
+    switch (width)
+    {
+    case 1: return _mm256_set1_epi8((char)value);
+    case 2: return _mm256_set1_epi16((short)value);
+    case 4: return _mm256_set1_epi32((int)value);
+    default: return _mm256_set1_epi64x((long long)value);
+    }
+}
+
+SG_CPU_TARGET_AVX2 static inline __m256i sg_avx2_cmpeq(__m256i a, __m256i b, sg_u32 width)
+{
+    switch (width)
+    {
+    case 1: return _mm256_cmpeq_epi8(a, b);
+    case 2: return _mm256_cmpeq_epi16(a, b);
+    case 4: return _mm256_cmpeq_epi32(a, b);
+    default: return _mm256_cmpeq_epi64(a, b);
+    }
+}
+
+SG_CPU_TARGET_AVX2 static inline sg_u32 sg_find_avx2_width(const sg_u8* p_data, sg_u32 count, sg_u64 value, sg_u32 width)
+{
+    __m256i needle = sg_avx2_set1(value, width);
+    sg_u32 lanes = 32 / width;
+    sg_u32 i = 0;
+    while (i + lanes <= count)
+    {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(p_data + (sg_u64)i * width));
+        sg_u32 mask = (sg_u32)_mm256_movemask_epi8(sg_avx2_cmpeq(block, needle, width));
+        if (mask)
+            return i + sg_ctz(mask) / width;
+
+        i += lanes;
+    }
+
+    return sg_find_range(p_data, i, count, value, width);
+}
+
+SG_CPU_TARGET_AVX2 static sg_u32 sg_find_avx2(const sg_u8* p_data, sg_u32 count, sg_u64 value, sg_u32 width)
+{
+    switch (width)
+    {
+    case 1: return sg_find_avx2_width(p_data, count, value, 1);
+    case 2: return sg_find_avx2_width(p_data, count, value, 2);
+    case 4: return sg_find_avx2_width(p_data, count, value, 4);
+    default: return sg_find_avx2_width(p_data, count, value, 8);
+    }
+}
+
+SG_CPU_TARGET_AVX2 static inline sg_u32 sg_count_avx2_width(const sg_u8* p_data, sg_u32 count, sg_u64 value, sg_u32 width)
+{
+    __m256i needle = sg_avx2_set1(value, width);
+    sg_u32 lanes = 32 / width;
+    sg_u64 matches = 0;
+    sg_u32 i = 0;
+    while (i + lanes <= count)
+    {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(p_data + (sg_u64)i * width));
+        matches += sg_popcount((sg_u32)_mm256_movemask_epi8(sg_avx2_cmpeq(block, needle, width)));
+        i += lanes;
+    }
+
+    return (sg_u32)(matches / width) + sg_count_range(p_data, i, count, value, width);
+}
+
+SG_CPU_TARGET_AVX2 static sg_u32 sg_count_avx2(const sg_u8* p_data, sg_u32 count, sg_u64 value, sg_u32 width)
+{
+    switch (width)
+    {
+    case 1: return sg_count_avx2_width(p_data, count, value, 1);
+    case 2: return sg_count_avx2_width(p_data, count, value, 2);
+    case 4: return sg_count_avx2_width(p_data, count, value, 4);
+    default: return sg_count_avx2_width(p_data, count, value, 8);
+    }
+}
+
+SG_CPU_TARGET_AVX2 static inline void sg_min_max_avx2_width(const sg_u8* p_data, sg_u32 count, sg_u32 width, sg_u64* p_min, sg_u64* p_max)
+{
+    // Unsigned lanes up to 32 bits compare natively, 64 bit lanes are biased into signed order
+    sg_u32 lanes = 32 / width;
+    if (count < lanes)
+    {
+        sg_min_max_range(p_data, 0, count, width, p_min, p_max);
+        return;
+    }
+
+    __m256i bias = _mm256_set1_epi64x((long long)0x8000000000000000ull);
+    __m256i lo = _mm256_loadu_si256((const __m256i*)p_data);
+    if (width == 8) lo = _mm256_xor_si256(lo, bias);
+    __m256i hi = lo;
+
+    sg_u32 i = lanes;
+    while (i + lanes <= count)
+    {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(p_data + (sg_u64)i * width));
+        switch (width)
+        {
+        case 1: lo = _mm256_min_epu8(lo, block); hi = _mm256_max_epu8(hi, block); break;
+        case 2: lo = _mm256_min_epu16(lo, block); hi = _mm256_max_epu16(hi, block); break;
+        case 4: lo = _mm256_min_epu32(lo, block); hi = _mm256_max_epu32(hi, block); break;
+        default:
+            block = _mm256_xor_si256(block, bias);
+            lo = _mm256_blendv_epi8(lo, block, _mm256_cmpgt_epi64(lo, block));
+            hi = _mm256_blendv_epi8(hi, block, _mm256_cmpgt_epi64(block, hi));
+            break;
+        }
+
+        i += lanes;
+    }
+
+    if (width == 8)
+    {
+        lo = _mm256_xor_si256(lo, bias);
+        hi = _mm256_xor_si256(hi, bias);
+    }
+
+    sg_u8 lo_lanes[32];
+    sg_u8 hi_lanes[32];
+    _mm256_storeu_si256((__m256i*)lo_lanes, lo);
+    _mm256_storeu_si256((__m256i*)hi_lanes, hi);
+    sg_min_max_range(lo_lanes, 0, lanes, width, p_min, p_max);
+    sg_min_max_range(hi_lanes, 0, lanes, width, p_min, p_max);
+    sg_min_max_range(p_data, i, count, width, p_min, p_max);
+}
+
+SG_CPU_TARGET_AVX2 static void sg_min_max_avx2(const sg_u8* p_data, sg_u32 count, sg_u32 width, sg_u64* p_min, sg_u64* p_max)
+{
+    switch (width)
+    {
+    case 1: sg_min_max_avx2_width(p_data, count, 1, p_min, p_max); break;
+    case 2: sg_min_max_avx2_width(p_data, count, 2, p_min, p_max); break;
+    case 4: sg_min_max_avx2_width(p_data, count, 4, p_min, p_max); break;
+    default: sg_min_max_avx2_width(p_data, count, 8, p_min, p_max); break;
+    }
+}
+
+SG_CPU_TARGET_AVX2 static void sg_fill_avx2(sg_u8* p_data, sg_u32 count, sg_u32 stride, const sg_u8* p_value)
+{
+    if (32 % stride != 0)
+    {
+        sg_fill_scalar(p_data, count, stride, p_value);
+        return;
+    }
+
+    sg_u8 pattern[32];
+    sg_fill_range(pattern, 0, 32, stride, p_value);
+    __m256i block = _mm256_loadu_si256((const __m256i*)pattern);
+
+    sg_u64 size = (sg_u64)count * stride;
+    sg_u64 byte_offset = 0;
+    while (byte_offset + 32 <= size)
+    {
+        _mm256_storeu_si256((__m256i*)(p_data + byte_offset), block);
+        byte_offset += 32;
+    }
+
+    memcpy(p_data + byte_offset, pattern, (size_t)(size - byte_offset));
+}
+
+SG_CPU_TARGET_AVX2 static void sg_gather_avx2(const sg_u8* p_data, sg_u32 count, sg_u32 stride, sg_u32 offset, sg_u32 size, sg_u8* p_output)
+{
+    // Hardware gathers take 32 bit offsets, 4 and 8 byte fields of elements up to 256 MB apart
+    if ((size != 4 && size != 8) || stride >= (1U << 28))
+    {
+        sg_gather_scalar(p_data, count, stride, offset, size, p_output);
+        return;
+    }
+
+    __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32((int)stride));
+    sg_u32 lanes = 32 / size;
+    sg_u32 i = 0;
+    while (i + lanes <= count)
+    {
+        const sg_u8* p_base = p_data + (sg_u64)i * stride + offset;
+        __m256i block;
+        if (size == 4)
+            block = _mm256_i32gather_epi32((const int*)p_base, offsets, 1);
+        else
+            block = _mm256_i32gather_epi64((const long long*)p_base, _mm256_castsi256_si128(offsets), 1);
+
+        _mm256_storeu_si256((__m256i*)(p_output + (sg_u64)i * size), block);
+        i += lanes;
+    }
+
+    sg_gather_range(p_data, i, count, stride, offset, size, p_output);
+}
+
+SG_CPU_TARGET_AVX2 static sg_u8 sg_equal_avx2(const sg_u8* p_data_a, const sg_u8* p_data_b, sg_u64 size)
+{
+    sg_u64 byte_offset = 0;
+    while (byte_offset + 32 <= size)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(p_data_a + byte_offset));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(p_data_b + byte_offset));
+        if ((sg_u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)) != 0xFFFFFFFFU)
+            return 0;
+
+        byte_offset += 32;
+    }
+
+    return memcmp(p_data_a + byte_offset, p_data_b + byte_offset, (size_t)(size - byte_offset)) == 0;
+}
+
+
+/* AVX-512, 64 bytes at a time with one mask bit per element */
+
+static inline sg_u32 sg_ctz64(sg_u64 mask)
+{
+    sg_u32 lo = (sg_u32)mask;
+    return lo ? sg_ctz(lo) : 32 + sg_ctz((sg_u32)(mask >> 32));
+}
+
+SG_CPU_TARGET_AVX512 static inline __m512i sg_avx512_set1(sg_u64 value, sg_u32 width)
+{
+    switch (width)
+    {
+    case 1: return _mm512_set1_epi8((char)value);
+    case 2: return _mm512_set1_epi16((short)value);
+    case 4: return _mm512_set1_epi32((int)value);
+    default: return _mm512_set1_epi64((long long)value);
+    }
+}
+
+SG_CPU_TARGET_AVX512 static inline sg_u64 sg_avx512_cmpeq(__m512i a, __m512i b, sg_u32 width)
+{
+    switch (width)
+    {
+    case 1: return (sg_u64)_mm512_cmpeq_epi8_mask(a, b);
+    case 2: return (sg_u64)_mm512_cmpeq_epi16_mask(a, b);
+    case 4: return (sg_u64)_mm512_cmpeq_epi32_mask(a, b);
+    default: return (sg_u64)_mm512_cmpeq_epi64_mask(a, b);
+    }
+}
+
+SG_CPU_TARGET_AVX512 static inline sg_u32 sg_find_avx512_width(const sg_u8* p_data, sg_u32 count, sg_u64 value, sg_u32 width)
+{
+    __m512i needle = sg_avx512_set1(value, width);
+    sg_u32 lanes = 64 / width;
+    sg_u32 i = 0;
+    while (i + lanes <= count)
+    {
+        __m512i block = _mm512_loadu_si512((const void*)(p_data + (sg_u64)i * width));
+        sg_u64 mask = sg_avx512_cmpeq(block, needle, width);
+        if (mask)
+            return i + sg_ctz64(mask);
+
+        i += lanes;
+    }
+
+    return sg_find_range(p_data, i, count, value, width);
+}
+
+SG_CPU_TARGET_AVX512 static sg_u32 sg_find_avx512(const sg_u8* p_data, sg_u32 count, sg_u64 value, sg_u32 width)
+{
+    switch (width)
+    {
+    case 1: return sg_find_avx512_width(p_data, count, value, 1);
+    case 2: return sg_find_avx512_width(p_data, count, value, 2);
+    case 4: return sg_find_avx512_width(p_data, count, value, 4);
+    default: return sg_find_avx512_width(p_data, count, value, 8);
+    }
+}
+
+SG_CPU_TARGET_AVX512 static inline sg_u32 sg_count_avx512_width(const sg_u8* p_data, sg_u32 count, sg_u64 value, sg_u32 width)
+{
+    __m512i needle = sg_avx512_set1(value, width);
+    sg_u32 lanes = 64 / width;
+    sg_u32 matches = 0;
+    sg_u32 i = 0;
+    while (i + lanes <= count)
+    {
+        __m512i block = _mm512_loadu_si512((const void*)(p_data + (sg_u64)i * width));
+        sg_u64 mask = sg_avx512_cmpeq(block, needle, width);
+        matches += sg_popcount((sg_u32)mask) + sg_popcount((sg_u32)(mask >> 32));
+        i += lanes;
+    }
+
+    return matches + sg_count_range(p_data, i, count, value, width);
+}
+
+SG_CPU_TARGET_AVX512 static sg_u32 sg_count_avx512(const sg_u8* p_data, sg_u32 count, sg_u64 value, sg_u32 width)
+{
+    switch (width)
+    {
+    case 1: return sg_count_avx512_width(p_data, count, value, 1);
+    case 2: return sg_count_avx512_width(p_data, count, value, 2);
+    case 4: return sg_count_avx512_width(p_data, count, value, 4);
+    default: return sg_count_avx512_width(p_data, count, value, 8);
+    }
+}
+
+SG_CPU_TARGET_AVX512 static void sg_fill_avx512(sg_u8* p_data, sg_u32 count, sg_u32 stride, const sg_u8* p_value)
+{
+    if (64 % stride != 0)
+    {
+        sg_fill_scalar(p_data, count, stride, p_value);
+        return;
+    }
+
+    sg_u8 pattern[64];
+    sg_fill_range(pattern, 0, 64, stride, p_value);
+    __m512i block = _mm512_loadu_si512((const void*)pattern);
+
+    sg_u64 size = (sg_u64)count * stride;
+    sg_u64 byte_offset = 0;
+    while (byte_offset + 64 <= size)
+    {
+        _mm512_storeu_si512((void*)(p_data + byte_offset), block);
+        byte_offset += 64;
+    }
+
+    memcpy(p_data + byte_offset, pattern, (size_t)(size - byte_offset));
+}
+
+SG_CPU_TARGET_AVX512 static sg_u8 sg_equal_avx512(const sg_u8* p_data_a, const sg_u8* p_data_b, sg_u64 size)
+{
+    sg_u64 byte_offset = 0;
+    while (byte_offset + 64 <= size)
+    {
+        __m512i a = _mm512_loadu_si512((const void*)(p_data_a + byte_offset));
+        __m512i b = _mm512_loadu_si512((const void*)(p_data_b + byte_offset));
+        if (_mm512_cmpneq_epi8_mask(a, b))
+            return 0;
+
+        byte_offset += 64;
+    }
+
+    return memcmp(p_data_a + byte_offset, p_data_b + byte_offset, (size_t)(size - byte_offset)) == 0;
+}
+
+#endif
+
+void sg_slice_kernels_fill(sg_cpu_dispatch* p_dispatch, sg_u32 level)
+{
+    p_dispatch->p_slice_find = &sg_find_scalar;
+    p_dispatch->p_slice_count = &sg_count_scalar;
+    p_dispatch->p_slice_min_max = &sg_min_max_scalar;
+    p_dispatch->p_slice_fill = &sg_fill_scalar;
+    p_dispatch->p_slice_gather = &sg_gather_scalar;
+    p_dispatch->p_slice_equal = &sg_equal_scalar;
+
+#if SG_CPU_X86
+    // SSE2 has no gather so it keeps the scalar loop
+    if (level >= SG_CPU_LEVEL_SSE2)
+    {
+        p_dispatch->p_slice_find = &sg_find_sse2;
+        p_dispatch->p_slice_count = &sg_count_sse2;
+        p_dispatch->p_slice_min_max = &sg_min_max_sse2;
+        p_dispatch->p_slice_fill = &sg_fill_sse2;
+        p_dispatch->p_slice_equal = &sg_equal_sse2;
+    }
+
+    if (level >= SG_CPU_LEVEL_AVX2)
+    {
+        p_dispatch->p_slice_find = &sg_find_avx2;
+        p_dispatch->p_slice_count = &sg_count_avx2;
+        p_dispatch->p_slice_min_max = &sg_min_max_avx2;
+        p_dispatch->p_slice_fill = &sg_fill_avx2;
+        p_dispatch->p_slice_gather = &sg_gather_avx2;
+        p_dispatch->p_slice_equal = &sg_equal_avx2;
+    }
+
+    // Min, max and gather gain little from the wider registers and keep the AVX2 versions
+    if (level >= SG_CPU_LEVEL_AVX512)
+    {
+        p_dispatch->p_slice_find = &sg_find_avx512;
+        p_dispatch->p_slice_count = &sg_count_avx512;
+        p_dispatch->p_slice_fill = &sg_fill_avx512;
+        p_dispatch->p_slice_equal = &sg_equal_avx512;
+    }
+#else
+    (void)level;
+#endif
+}
+
+static inline sg_u32 sg_slice_width(sg_slice* p_slice)
+{
+    sg_u32 width = p_slice->_stride;
+    SG_ASSERT(width == 1 || width == 2 || width == 4 || width == 8);
+    return width;
+}
+
+sg_u32 sg_slice_find(sg_slice* p_slice, sg_u64 value)
+{
+    sg_u32 width = sg_slice_width(p_slice);
+    if (value > sg_width_max(width))
+        return SG_SLICE_IDX_NULL;
+
+    return sg_cpu_dispatch_table()->p_slice_find(p_slice->_data, p_slice->_count, value, width);
+}
+
+sg_u32 sg_slice_count(sg_slice* p_slice, sg_u64 value)
+{
+    sg_u32 width = sg_slice_width(p_slice);
+    if (value > sg_width_max(width))
+        return 0;
+
+    return sg_cpu_dispatch_table()->p_slice_count(p_slice->_data, p_slice->_count, value, width);
+}
+
+sg_u8 sg_slice_min_max(sg_slice* p_slice, sg_u64* p_min, sg_u64* p_max)
+{
+    sg_u32 width = sg_slice_width(p_slice);
+    if (p_slice->_count == 0)
+        return 0;
+
+    *p_min = ~0ull;
+    *p_max = 0;
+    sg_cpu_dispatch_table()->p_slice_min_max(p_slice->_data, p_slice->_count, width, p_min, p_max);
+    return 1;
+}
+
+void sg_slice_fill(sg_slice* p_slice, const void* p_value)
+{
+    if (p_slice->_count)
+        sg_cpu_dispatch_table()->p_slice_fill(p_slice->_data, p_slice->_count, p_slice->_stride, (const sg_u8*)p_value);
+}
+
+void sg_slice_gather(sg_slice* p_slice, sg_u32 offset, sg_u32 size, void* p_output)
+{
+    SG_ASSERT(offset + size <= p_slice->_stride);
+
+    if (p_slice->_count)
+        sg_cpu_dispatch_table()->p_slice_gather(p_slice->_data, p_slice->_count, p_slice->_stride, offset, size, (sg_u8*)p_output);
+}
+
+sg_u8 sg_slice_equal(sg_slice* p_slice_a, sg_slice* p_slice_b)
+{
+    if (p_slice_a->_count != p_slice_b->_count || p_slice_a->_stride != p_slice_b->_stride)
+        return 0;
+
+    if (p_slice_a->_data == p_slice_b->_data)
+        return 1;
+
+    return sg_cpu_dispatch_table()->p_slice_equal(p_slice_a->_data, p_slice_b->_data, (sg_u64)p_slice_a->_count * p_slice_a->_stride);
+}
@@ -0,0 +1,134 @@
+#include "sg_snapshot.h"
+#include "sg_assert.h"
+#include <string.h>
+
+static const sg_u64 s_prime_0 = 0x9e3779b185ebca87ull;
+static const sg_u64 s_prime_1 = 0xc2b2ae3d27d4eb4full;
+
+static inline sg_u64 sg_rotl(sg_u64 value, sg_u32 bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static inline sg_u64 sg_mix(sg_u64 checksum, sg_u64 word)
+{
+    return sg_rotl(checksum ^ (word * s_prime_1), 31) * s_prime_0;
+}
+
+sg_u64 sg_snapshot_checksum(sg_u64 checksum, const void* p_data, sg_u64 size)
+{
+    // Eight bytes per step so multi-GB payloads check at memory speed
+    const sg_u8* p_bytes = (const sg_u8*)p_data;
+    sg_u64 i = 0;
+    while (i + sizeof(sg_u64) <= size)
+    {
+        sg_u64 word;
+        memcpy(&word, p_bytes + i, sizeof(sg_u64));
+        checksum = sg_mix(checksum, word);
+        i += sizeof(sg_u64);
+    }
+
+    sg_u64 tail = 0;
+    if (i < size)
+        memcpy(&tail, p_bytes + i, (size_t)(size - i));
+
+    return sg_mix(checksum, tail ^ size);
+}
+
+sg_u8 sg_snapshot_save(const char* path, sg_snapshot_header* p_header, const void* const* pp_parts, const sg_u64* p_sizes, sg_u32 count)
+{
+    p_header->magic = SG_SNAPSHOT_MAGIC;
+    p_header->version = SG_SNAPSHOT_VERSION;
+    p_header->header_size = sizeof(sg_snapshot_header);
+    p_header->payload_size = 0;
+    p_header->checksum = 0;
+
+    sg_u32 i = 0;
+    while (i < count)
+    {
+        p_header->payload_size += p_sizes[i];
+        i += 1;
+    }
+
+    // The header is checked with its checksum field zeroed, then the parts in order
+    sg_u64 checksum = sg_snapshot_checksum(0, p_header, sizeof(sg_snapshot_header));
+
+    i = 0;
+    while (i < count)
+    {
+        checksum = sg_snapshot_checksum(checksum, pp_parts[i], p_sizes[i]);
+        i += 1;
+    }
+
+    p_header->checksum = checksum;
+
+    FILE* p_file = fopen(path, "wb");
+    if (p_file == NULL)
+        return 0;
+
+    sg_u8 written = fwrite(p_header, sizeof(sg_snapshot_header), 1, p_file) == 1;
+
+    i = 0;
+    while (written && i < count)
+    {
+        if (p_sizes[i])
+            written = fwrite(pp_parts[i], (size_t)p_sizes[i], 1, p_file) == 1;
+
+        i += 1;
+    }
+
+    return fclose(p_file) == 0 && written;
+}
+
+sg_u8 sg_snapshot_open(sg_snapshot_reader* p_reader, const char* path, sg_u32 kind, sg_snapshot_header* p_header)
+{
+    p_reader->_file = NULL;
+    p_reader->_checksum = 0;
+    p_reader->_remaining = 0;
+
+    FILE* p_file = fopen(path, "rb");
+    if (p_file == NULL)
+        return 0;
+
+    if (fread(p_header, sizeof(sg_snapshot_header), 1, p_file) != 1 ||
+        p_header->magic != SG_SNAPSHOT_MAGIC ||
+        p_header->version != SG_SNAPSHOT_VERSION ||
+        p_header->header_size != sizeof(sg_snapshot_header) ||
+        p_header->kind != kind)
+    {
+        fclose(p_file);
+        return 0;
+    }
+
+    sg_snapshot_header checked = *p_header;
+    checked.checksum = 0;
+
+    p_reader->_file = p_file;
+    p_reader->_checksum = sg_snapshot_checksum(0, &checked, sizeof(sg_snapshot_header));
+    p_reader->_remaining = p_header->payload_size;
+    return 1;
+}
+
+sg_u8 sg_snapshot_read(sg_snapshot_reader* p_reader, void* p_data, sg_u64 size)
+{
+    if (p_reader->_file == NULL || size > p_reader->_remaining)
+        return 0;
+
+    if (size && fread(p_data, (size_t)size, 1, p_reader->_file) != 1)
+        return 0;
+
+    p_reader->_checksum = sg_snapshot_checksum(p_reader->_checksum, p_data, size);
+    p_reader->_remaining -= size;
+    return 1;
+}
+
+sg_u8 sg_snapshot_close(sg_snapshot_reader* p_reader, const sg_snapshot_header* p_header)
+{
+    if (p_reader->_file == NULL)
+        return 0;
+
+    fclose(p_reader->_file);
+    p_reader->_file = NULL;
+
+    return p_reader->_remaining == 0 && p_reader->_checksum == p_header->checksum;
+}
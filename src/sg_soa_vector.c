@@ -0,0 +1,210 @@
+#include "sg_soa_vector.h"
+#include "sg_allocator.h"
+#include "sg_assert.h"
+#include <string.h>
+
+static inline sg_u64 sg_column_size(sg_u32 capacity, sg_u32 stride)
+{
+    sg_u64 alignment = SG_SOA_VECTOR_COLUMN_ALIGNMENT;
+    return ((sg_u64)capacity * stride + alignment - 1) & ~(alignment - 1);
+}
+
+static sg_u8 sg_soa_vector_reallocate(sg_soa_vector* p_vector, sg_u32 capacity)
+{
+    /* 1. Allocate one block holding every column at the new capacity, the vector is left as it was on failure
+       2. Copy the live elements of each column over
+       3. Release the old block */
+    sg_u64 size = 0;
+    sg_u32 i = 0;
+    while (i < p_vector->_column_count)
+    {
+        size += sg_column_size(capacity, p_vector->_strides[i]);
+        i += 1;
+    }
+
+    sg_u8* p_allocation = (sg_u8*)sg_allocator_allocate_aligned(p_vector->p_allocator, size, SG_SOA_VECTOR_COLUMN_ALIGNMENT);
+    if (p_allocation == NULL)
+        return 0;
+
+    sg_u8* p_column = p_allocation;
+    i = 0;
+    while (i < p_vector->_column_count)
+    {
+        sg_u64 live_size = (sg_u64)p_vector->_size * p_vector->_strides[i];
+        if (live_size)
+            memcpy_s(p_column, live_size, p_vector->_columns[i], live_size);
+
+        p_vector->_columns[i] = p_column;
+        p_column += sg_column_size(capacity, p_vector->_strides[i]);
+        i += 1;
+    }
+
+    sg_allocator_free_aligned(p_vector->p_allocator, p_vector->_allocation);
+    p_vector->_allocation = p_allocation;
+    p_vector->_capacity = capacity;
+    return 1;
+}
+
+sg_soa_vector sg_soa_vector_create(sg_u32 size, const sg_u32* p_strides, sg_u32 column_count, sg_allocator* p_allocator)
+{
+    SG_ASSERT(column_count != 0 && column_count <= SG_SOA_VECTOR_MAX_COLUMNS);
+
+    if (p_allocator == NULL)
+        p_allocator = &s_allocator_default;
+
+    sg_soa_vector vector;
+    memset(&vector, 0, sizeof(sg_soa_vector));
+    vector.p_allocator = p_allocator;
+    vector._column_count = column_count;
+
+    sg_u32 i = 0;
+    while (i < column_count)
+    {
+        SG_ASSERT(p_strides[i] != 0);
+        vector._strides[i] = p_strides[i];
+        i += 1;
+    }
+
+    sg_soa_vector_resize(&vector, size);
+    return vector;
+}
+
+void sg_soa_vector_destroy(sg_soa_vector* p_vector)
+{
+    if (p_vector->_allocation)
+        sg_allocator_free_aligned(p_vector->p_allocator, p_vector->_allocation);
+
+    memset(p_vector, 0, sizeof(sg_soa_vector));
+}
+
+sg_u8 sg_soa_vector_reserve(sg_soa_vector* p_vector, sg_u32 size)
+{
+    if (p_vector->_capacity < size)
+        return sg_soa_vector_reallocate(p_vector, size);
+
+    return 1;
+}
+
+sg_u8 sg_soa_vector_resize(sg_soa_vector* p_vector, sg_u32 size)
+{
+    if (!sg_soa_vector_reserve(p_vector, size))
+        return 0;
+
+    if (size > p_vector->_size)
+    {
+        sg_u32 i = 0;
+        while (i < p_vector->_column_count)
+        {
+            sg_u32 stride = p_vector->_strides[i];
+            memset(p_vector->_columns[i] + (sg_u64)p_vector->_size * stride, 0, (sg_u64)(size - p_vector->_size) * stride);
+            i += 1;
+        }
+    }
+
+    p_vector->_size = size;
+    return 1;
+}
+
+// Makes room for one more element, fails once the size can not be indexed below SG_SOA_VECTOR_IDX_NULL
+static inline sg_u8 sg_soa_vector_grow(sg_soa_vector* p_vector)
+{
+    if (p_vector->_size >= SG_SOA_VECTOR_IDX_NULL)
+        return 0;
+
+    if (p_vector->_capacity == p_vector->_size)
+    {
+        sg_u64 capacity = (sg_u64)p_vector->_capacity * 2;
+        if (capacity == 0)
+            capacity = SG_SOA_VECTOR_COLUMN_ALIGNMENT / sizeof(sg_u32);
+        if (capacity > 0xFFFFFFFFull)
+            capacity = 0xFFFFFFFFull;
+
+        return sg_soa_vector_reallocate(p_vector, (sg_u32)capacity);
+    }
+
+    return 1;
+}
+
+sg_u32 sg_soa_vector_emplace(sg_soa_vector* p_vector)
+{
+    sg_u32 index = p_vector->_size;
+    if (!sg_soa_vector_grow(p_vector))
+        return SG_SOA_VECTOR_IDX_NULL;
+
+    sg_soa_vector_resize(p_vector, index + 1);
+    return index;
+}
+
+sg_u32 sg_soa_vector_push(sg_soa_vector* p_vector, const void* const* p_fields)
+{
+    sg_u32 index = p_vector->_size;
+    if (!sg_soa_vector_grow(p_vector))
+        return SG_SOA_VECTOR_IDX_NULL;
+
+    sg_u32 i = 0;
+    while (i < p_vector->_column_count)
+    {
+        sg_u32 stride = p_vector->_strides[i];
+        memcpy_s(p_vector->_columns[i] + (sg_u64)index * stride, stride, p_fields[i], stride);
+        i += 1;
+    }
+
+    p_vector->_size = index + 1;
+    return index;
+}
+
+void sg_soa_vector_erase(sg_soa_vector* p_vector, sg_u32 index)
+{
+    SG_ASSERT(index < p_vector->_size);
+
+    sg_u32 i = 0;
+    while (i < p_vector->_column_count)
+    {
+        sg_u32 stride = p_vector->_strides[i];
+        sg_u8* p_data = p_vector->_columns[i] + (sg_u64)index * stride;
+        memmove(p_data, p_data + stride, (sg_u64)(p_vector->_size - index - 1) * stride);
+        i += 1;
+    }
+
+    p_vector->_size -= 1;
+}
+
+void sg_soa_vector_erase_swap(sg_soa_vector* p_vector, sg_u32 index)
+{
+    SG_ASSERT(index < p_vector->_size);
+
+    sg_u32 last = p_vector->_size - 1;
+    if (index != last)
+    {
+        sg_u32 i = 0;
+        while (i < p_vector->_column_count)
+        {
+            sg_u32 stride = p_vector->_strides[i];
+            sg_u8* p_column = p_vector->_columns[i];
+            memcpy_s(p_column + (sg_u64)index * stride, stride, p_column + (sg_u64)last * stride, stride);
+            i += 1;
+        }
+    }
+
+    p_vector->_size = last;
+}
+
+sg_u32 sg_soa_vector_size(sg_soa_vector* p_vector)
+{
+    return p_vector->_size;
+}
+
+void* sg_soa_vector_data(sg_soa_vector* p_vector, sg_u32 column, sg_u32 index)
+{
+    SG_ASSERT(column < p_vector->_column_count);
+    SG_ASSERT(index < p_vector->_size);
+
+    return p_vector->_columns[column] + (sg_u64)index * p_vector->_strides[column];
+}
+
+sg_slice sg_soa_vector_column(sg_soa_vector* p_vector, sg_u32 column)
+{
+    SG_ASSERT(column < p_vector->_column_count);
+
+    return sg_slice_make(p_vector->_columns[column], 0, p_vector->_size, p_vector->_strides[column]);
+}
@@ -0,0 +1,213 @@
+#include "sg_sort.h"
+#include "sg_allocator.h"
+#include "sg_assert.h"
+#include "sg_parallel.h"
+#include <string.h>
+
+#define SG_SORT_HISTOGRAM 0U
+#define SG_SORT_SCATTER 1U
+
+typedef struct sg_sort_block
+{
+    sg_u32 begin;
+    sg_u32 end;
+    sg_u32 counts[SG_SORT_RADIX_BUCKETS];
+} sg_sort_block;
+
+typedef struct sg_sort_job
+{
+    const sg_u8* p_source;
+    sg_u8* p_destination;
+    sg_u32 stride;
+    sg_u32 key_offset;
+    sg_u32 key_size;
+    sg_u32 shift;
+    sg_u32 phase;
+} sg_sort_job;
+
+static inline sg_u32 sg_sort_digit(const sg_sort_job* p_job, const sg_u8* p_element)
+{
+    // Keys inside strided elements need not be aligned
+    if (p_job->key_size == sizeof(sg_u32))
+    {
+        sg_u32 key;
+        memcpy(&key, p_element + p_job->key_offset, sizeof(sg_u32));
+        return (key >> p_job->shift) & (SG_SORT_RADIX_BUCKETS - 1);
+    }
+
+    sg_u64 key;
+    memcpy(&key, p_element + p_job->key_offset, sizeof(sg_u64));
+    return (sg_u32)(key >> p_job->shift) & (SG_SORT_RADIX_BUCKETS - 1);
+}
+
+static inline void sg_sort_copy(sg_u8* p_destination, const sg_u8* p_source, sg_u32 stride)
+{
+    // Fixed sizes become plain moves
+    switch (stride)
+    {
+    case 4: memcpy(p_destination, p_source, 4); break;
+    case 8: memcpy(p_destination, p_source, 8); break;
+    case 12: memcpy(p_destination, p_source, 12); break;
+    case 16: memcpy(p_destination, p_source, 16); break;
+    default: memcpy(p_destination, p_source, stride); break;
+    }
+}
+
+static void sg_sort_block_pass(sg_sort_job* p_job, sg_sort_block* p_block)
+{
+    sg_u32 stride = p_job->stride;
+    const sg_u8* p_element = p_job->p_source + (sg_u64)p_block->begin * stride;
+    const sg_u8* p_end = p_job->p_source + (sg_u64)p_block->end * stride;
+
+    if (p_job->phase == SG_SORT_HISTOGRAM)
+    {
+        memset(p_block->counts, 0, sizeof(p_block->counts));
+        while (p_element < p_end)
+        {
+            p_block->counts[sg_sort_digit(p_job, p_element)] += 1;
+            p_element += stride;
+        }
+    }
+    else
+    {
+        // Counts now hold where this block's next element of each digit goes
+        while (p_element < p_end)
+        {
+            sg_u32 digit = sg_sort_digit(p_job, p_element);
+            sg_sort_copy(p_job->p_destination + (sg_u64)p_block->counts[digit] * stride, p_element, stride);
+            p_block->counts[digit] += 1;
+            p_element += stride;
+        }
+    }
+}
+
+static void sg_sort_blocks(sg_slice* p_blocks, sg_u32 offset, void* p_user_data)
+{
+    (void)offset;
+
+    sg_u32 i = 0;
+    while (i < p_blocks->_count)
+    {
+        sg_sort_block_pass((sg_sort_job*)p_user_data, (sg_sort_block*)sg_slice_data(p_blocks, i));
+        i += 1;
+    }
+}
+
+static sg_u8 sg_sort_offsets(sg_sort_block* p_blocks, sg_u32 block_count, sg_u32 count)
+{
+    /* 1. Total each digit over all blocks, a digit holding every key means the pass changes nothing
+       2. Turn the counts into destinations, digits in order and blocks in order within a digit for stability */
+    sg_u32 digit = 0;
+    while (digit < SG_SORT_RADIX_BUCKETS)
+    {
+        sg_u32 total = 0;
+        sg_u32 b = 0;
+        while (b < block_count)
+        {
+            total += p_blocks[b].counts[digit];
+            b += 1;
+        }
+
+        if (total == count)
+            return 0;
+
+        digit += 1;
+    }
+
+    sg_u32 base = 0;
+    digit = 0;
+    while (digit < SG_SORT_RADIX_BUCKETS)
+    {
+        sg_u32 b = 0;
+        while (b < block_count)
+        {
+            sg_u32 digit_count = p_blocks[b].counts[digit];
+            p_blocks[b].counts[digit] = base;
+            base += digit_count;
+            b += 1;
+        }
+
+        digit += 1;
+    }
+
+    return 1;
+}
+
+void sg_sort_radix(sg_parallel_pool* p_pool, sg_slice* p_slice, sg_u32 key_offset, sg_u32 key_size, sg_allocator* p_allocator)
+{
+    SG_ASSERT(key_size == sizeof(sg_u32) || key_size == sizeof(sg_u64));
+    SG_ASSERT(key_offset + key_size <= p_slice->_stride);
+
+    sg_u32 count = p_slice->_count;
+    if (count < 2)
+        return;
+
+    if (p_allocator == NULL)
+        p_allocator = &s_allocator_default;
+
+    sg_u32 stride = p_slice->_stride;
+    sg_u64 byte_size = (sg_u64)count * stride;
+
+    // One block per worker, as long as each block has enough elements to pay for its histogram
+    sg_u32 block_count = p_pool ? p_pool->_worker_count : 1;
+    sg_u32 max_blocks = (count + SG_SORT_MIN_BLOCK - 1) / SG_SORT_MIN_BLOCK;
+    if (block_count > max_blocks)
+        block_count = max_blocks;
+
+    sg_sort_block* p_blocks = (sg_sort_block*)p_allocator->allocate(sizeof(sg_sort_block) * block_count, p_allocator->p_user_data);
+    sg_u8* p_scratch = (sg_u8*)p_allocator->allocate(byte_size, p_allocator->p_user_data);
+
+    sg_u32 b = 0;
+    while (b < block_count)
+    {
+        p_blocks[b].begin = (sg_u32)((sg_u64)count * b / block_count);
+        p_blocks[b].end = (sg_u32)((sg_u64)count * (b + 1) / block_count);
+        b += 1;
+    }
+
+    sg_slice blocks = sg_slice_make(p_blocks, 0, block_count, sizeof(sg_sort_block));
+
+    sg_sort_job job;
+    job.p_source = p_slice->_data;
+    job.p_destination = p_scratch;
+    job.stride = stride;
+    job.key_offset = key_offset;
+    job.key_size = key_size;
+
+    sg_u32 pass = 0;
+    while (pass < key_size * 8 / SG_SORT_RADIX_BITS)
+    {
+        job.shift = pass * SG_SORT_RADIX_BITS;
+        job.phase = SG_SORT_HISTOGRAM;
+        sg_parallel_for_each(p_pool, &blocks, 1, &sg_sort_blocks, &job);
+
+        if (sg_sort_offsets(p_blocks, block_count, count))
+        {
+            job.phase = SG_SORT_SCATTER;
+            sg_parallel_for_each(p_pool, &blocks, 1, &sg_sort_blocks, &job);
+
+            sg_u8* p_source = (sg_u8*)job.p_source;
+            job.p_source = job.p_destination;
+            job.p_destination = p_source;
+        }
+
+        pass += 1;
+    }
+
+    // An odd number of scatters leaves the result in the scratch copy
+    if (job.p_source != p_slice->_data)
+        memcpy_s(p_slice->_data, byte_size, job.p_source, byte_size);
+
+    p_allocator->free(p_scratch, p_allocator->p_user_data);
+    p_allocator->free(p_blocks, p_allocator->p_user_data);
+}
+
+void sg_sort_radix_u32(sg_parallel_pool* p_pool, sg_slice* p_slice, sg_allocator* p_allocator)
+{
+    sg_sort_radix(p_pool, p_slice, 0, sizeof(sg_u32), p_allocator);
+}
+
+void sg_sort_radix_u64(sg_parallel_pool* p_pool, sg_slice* p_slice, sg_allocator* p_allocator)
+{
+    sg_sort_radix(p_pool, p_slice, 0, sizeof(sg_u64), p_allocator);
+}
@@ -0,0 +1,263 @@
+#include "sg_stream.h"
+#include "sg_allocator.h"
+#include "sg_assert.h"
+#include "sg_vector.h"
+#include <string.h>
+
+static void sg_stream_read_main(void* p_user_data)
+{
+    sg_stream* p_stream = (sg_stream*)p_user_data;
+    sg_u32 idx = 0;
+    while (1)
+    {
+        /* 1. Wait for the caller to hand the chunk back
+           2. Fill it outside the lock
+           3. Publish it, an empty chunk marks the end */
+        sg_mutex_lock(&p_stream->_mutex);
+        while (p_stream->_full[idx] && !p_stream->_stop)
+            sg_condition_wait(&p_stream->_condition, &p_stream->_mutex);
+
+        sg_u8 stop = p_stream->_stop;
+        sg_mutex_unlock(&p_stream->_mutex);
+
+        if (stop)
+            return;
+
+        sg_u64 size = fread(p_stream->_chunks[idx], 1, (size_t)p_stream->_chunk_size, p_stream->_file);
+        sg_u8 error = ferror(p_stream->_file) != 0;
+
+        sg_mutex_lock(&p_stream->_mutex);
+        p_stream->_sizes[idx] = size;
+        p_stream->_full[idx] = 1;
+        p_stream->_error |= error;
+        sg_condition_broadcast(&p_stream->_condition);
+        sg_mutex_unlock(&p_stream->_mutex);
+
+        if (size < p_stream->_chunk_size)
+            return;
+
+        idx = (idx + 1) % SG_STREAM_CHUNK_COUNT;
+    }
+}
+
+static void sg_stream_write_main(void* p_user_data)
+{
+    sg_stream* p_stream = (sg_stream*)p_user_data;
+    sg_u32 idx = 0;
+    while (1)
+    {
+        sg_mutex_lock(&p_stream->_mutex);
+        while (!p_stream->_full[idx] && !p_stream->_stop)
+            sg_condition_wait(&p_stream->_condition, &p_stream->_mutex);
+
+        // Chunks are handed over in order so an empty next chunk after stop means everything is written
+        sg_u8 full = p_stream->_full[idx];
+        sg_mutex_unlock(&p_stream->_mutex);
+
+        if (!full)
+            return;
+
+        sg_u64 size = p_stream->_sizes[idx];
+        sg_u8 error = size && fwrite(p_stream->_chunks[idx], (size_t)size, 1, p_stream->_file) != 1;
+
+        sg_mutex_lock(&p_stream->_mutex);
+        p_stream->_full[idx] = 0;
+        p_stream->_sizes[idx] = 0;
+        p_stream->_error |= error;
+        sg_condition_broadcast(&p_stream->_condition);
+        sg_mutex_unlock(&p_stream->_mutex);
+
+        idx = (idx + 1) % SG_STREAM_CHUNK_COUNT;
+    }
+}
+
+static sg_u8 sg_stream_open(sg_stream* p_stream, const char* path, const char* mode, sg_u32 stride, sg_u64 chunk_size, sg_allocator* p_allocator, sg_thread_fn p_main)
+{
+    SG_ASSERT(stride != 0);
+
+    if (p_allocator == NULL)
+        p_allocator = &s_allocator_default;
+
+    if (chunk_size == 0)
+        chunk_size = SG_STREAM_CHUNK_SIZE;
+
+    // Whole elements only
+    chunk_size -= chunk_size % stride;
+    if (chunk_size == 0)
+        chunk_size = stride;
+
+    memset(p_stream, 0, sizeof(sg_stream));
+    p_stream->_file = fopen(path, mode);
+    if (p_stream->_file == NULL)
+        return 0;
+
+    p_stream->p_allocator = p_allocator;
+    p_stream->_chunk_size = chunk_size;
+    p_stream->_stride = stride;
+
+    /* 1. Take the chunks, the mutex and the condition
+       2. Start the thread last so nothing has to stop it on failure
+       3. Release whatever was acquired when any step fails */
+    sg_u8 chunks = 1;
+    sg_u32 i = 0;
+    while (i < SG_STREAM_CHUNK_COUNT)
+    {
+        p_stream->_chunks[i] = (sg_u8*)p_allocator->allocate(chunk_size, p_allocator->p_user_data);
+        chunks &= p_stream->_chunks[i] != NULL;
+        i += 1;
+    }
+
+    sg_u8 mutex = chunks && sg_mutex_init(&p_stream->_mutex);
+    sg_u8 condition = mutex && sg_condition_init(&p_stream->_condition);
+    if (condition && sg_thread_create(&p_stream->_thread, p_main, p_stream))
+        return 1;
+
+    if (condition)
+        sg_condition_destroy(&p_stream->_condition);
+    if (mutex)
+        sg_mutex_destroy(&p_stream->_mutex);
+
+    i = 0;
+    while (i < SG_STREAM_CHUNK_COUNT)
+    {
+        if (p_stream->_chunks[i])
+            p_allocator->free(p_stream->_chunks[i], p_allocator->p_user_data);
+
+        p_stream->_chunks[i] = NULL;
+        i += 1;
+    }
+
+    fclose(p_stream->_file);
+    p_stream->_file = NULL;
+    return 0;
+}
+
+static void sg_stream_close(sg_stream* p_stream)
+{
+    sg_mutex_lock(&p_stream->_mutex);
+    p_stream->_stop = 1;
+    sg_condition_broadcast(&p_stream->_condition);
+    sg_mutex_unlock(&p_stream->_mutex);
+
+    sg_thread_join(&p_stream->_thread);
+    sg_condition_destroy(&p_stream->_condition);
+    sg_mutex_destroy(&p_stream->_mutex);
+
+    sg_u32 i = 0;
+    while (i < SG_STREAM_CHUNK_COUNT)
+    {
+        if (p_stream->_chunks[i])
+            p_stream->p_allocator->free(p_stream->_chunks[i], p_stream->p_allocator->p_user_data);
+
+        p_stream->_chunks[i] = NULL;
+        i += 1;
+    }
+
+    if (fclose(p_stream->_file) != 0)
+        p_stream->_error = 1;
+
+    p_stream->_file = NULL;
+}
+
+sg_u8 sg_stream_reader_open(sg_stream_reader* p_reader, const char* path, sg_u32 stride, sg_u64 chunk_size, sg_allocator* p_allocator)
+{
+    return sg_stream_open(p_reader, path, "rb", stride, chunk_size, p_allocator, &sg_stream_read_main);
+}
+
+sg_u8 sg_stream_reader_next(sg_stream_reader* p_reader, sg_slice* p_slice)
+{
+    sg_mutex_lock(&p_reader->_mutex);
+
+    // Return the chunk the caller is done with so the thread can refill it
+    if (p_reader->_held && p_reader->_sizes[p_reader->_current] < p_reader->_chunk_size)
+    {
+        // A short chunk was the last one and the thread has finished, keep it as the end marker
+        p_reader->_sizes[p_reader->_current] = 0;
+        p_reader->_held = 0;
+    }
+    else if (p_reader->_held)
+    {
+        p_reader->_full[p_reader->_current] = 0;
+        p_reader->_held = 0;
+        p_reader->_current = (p_reader->_current + 1) % SG_STREAM_CHUNK_COUNT;
+        sg_condition_broadcast(&p_reader->_condition);
+    }
+
+    sg_u32 idx = p_reader->_current;
+    while (!p_reader->_full[idx])
+        sg_condition_wait(&p_reader->_condition, &p_reader->_mutex);
+
+    sg_u32 count = (sg_u32)(p_reader->_sizes[idx] / p_reader->_stride);
+    p_reader->_held = count != 0;
+    sg_mutex_unlock(&p_reader->_mutex);
+
+    // The end chunk stays full so later calls keep returning 0
+    if (count == 0)
+        return 0;
+
+    *p_slice = sg_slice_make(p_reader->_chunks[idx], 0, count, p_reader->_stride);
+    return 1;
+}
+
+sg_u8 sg_stream_reader_close(sg_stream_reader* p_reader)
+{
+    sg_stream_close(p_reader);
+    return !p_reader->_error;
+}
+
+sg_u8 sg_stream_writer_open(sg_stream_writer* p_writer, const char* path, sg_u64 chunk_size, sg_allocator* p_allocator)
+{
+    return sg_stream_open(p_writer, path, "wb", 1, chunk_size, p_allocator, &sg_stream_write_main);
+}
+
+static void sg_stream_writer_submit(sg_stream_writer* p_writer)
+{
+    // Hand the filled chunk to the thread and wait for the next one to drain
+    sg_mutex_lock(&p_writer->_mutex);
+    p_writer->_full[p_writer->_current] = 1;
+    p_writer->_current = (p_writer->_current + 1) % SG_STREAM_CHUNK_COUNT;
+    sg_condition_broadcast(&p_writer->_condition);
+
+    while (p_writer->_full[p_writer->_current])
+        sg_condition_wait(&p_writer->_condition, &p_writer->_mutex);
+
+    sg_mutex_unlock(&p_writer->_mutex);
+}
+
+void sg_stream_writer_write(sg_stream_writer* p_writer, const void* p_data, sg_u64 size)
+{
+    const sg_u8* p_bytes = (const sg_u8*)p_data;
+    while (size)
+    {
+        sg_u32 idx = p_writer->_current;
+        sg_u64 space = p_writer->_chunk_size - p_writer->_sizes[idx];
+        sg_u64 length = size < space ? size : space;
+
+        memcpy_s(p_writer->_chunks[idx] + p_writer->_sizes[idx], space, p_bytes, length);
+        p_writer->_sizes[idx] += length;
+        p_bytes += length;
+        size -= length;
+
+        if (p_writer->_sizes[idx] == p_writer->_chunk_size)
+            sg_stream_writer_submit(p_writer);
+    }
+}
+
+void sg_stream_writer_write_slice(sg_stream_writer* p_writer, sg_slice* p_slice)
+{
+    sg_stream_writer_write(p_writer, p_slice->_data, (sg_u64)p_slice->_count * p_slice->_stride);
+}
+
+void sg_stream_writer_write_vector(sg_stream_writer* p_writer, sg_vector* p_vector)
+{
+    sg_stream_writer_write(p_writer, p_vector->_buffer.allocation, (sg_u64)p_vector->_size * p_vector->_stride);
+}
+
+sg_u8 sg_stream_writer_close(sg_stream_writer* p_writer)
+{
+    if (p_writer->_sizes[p_writer->_current])
+        sg_stream_writer_submit(p_writer);
+
+    sg_stream_close(p_writer);
+    return !p_writer->_error;
+}
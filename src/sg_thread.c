@@ -0,0 +1,215 @@
+#include "sg_thread.h"
+#include "sg_assert.h"
+#include <stdlib.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+// Owned by the sg_thread from create to join
+typedef struct sg_thread_start
+{
+    sg_thread_fn p_fn;
+    void* p_user_data;
+#if defined(_WIN32)
+    HANDLE thread;
+#else
+    pthread_t thread;
+#endif
+} sg_thread_start;
+
+#if defined(_WIN32)
+static DWORD WINAPI sg_thread_main(LPVOID p_param)
+{
+    sg_thread_start* p_start = (sg_thread_start*)p_param;
+    p_start->p_fn(p_start->p_user_data);
+    return 0;
+}
+#else
+static void* sg_thread_main(void* p_param)
+{
+    sg_thread_start* p_start = (sg_thread_start*)p_param;
+    p_start->p_fn(p_start->p_user_data);
+    return NULL;
+}
+#endif
+
+sg_u8 sg_thread_create(sg_thread* p_thread, sg_thread_fn p_fn, void* p_user_data)
+{
+    p_thread->_handle = NULL;
+
+    sg_thread_start* p_start = (sg_thread_start*)malloc(sizeof(sg_thread_start));
+    if (p_start == NULL)
+        return 0;
+
+    p_start->p_fn = p_fn;
+    p_start->p_user_data = p_user_data;
+
+#if defined(_WIN32)
+    p_start->thread = CreateThread(NULL, 0, &sg_thread_main, p_start, 0, NULL);
+    sg_u8 created = p_start->thread != NULL;
+#else
+    sg_u8 created = pthread_create(&p_start->thread, NULL, &sg_thread_main, p_start) == 0;
+#endif
+
+    if (!created)
+    {
+        free(p_start);
+        return 0;
+    }
+
+    p_thread->_handle = p_start;
+    return 1;
+}
+
+void sg_thread_join(sg_thread* p_thread)
+{
+    sg_thread_start* p_start = (sg_thread_start*)p_thread->_handle;
+    if (p_start == NULL)
+        return;
+
+#if defined(_WIN32)
+    WaitForSingleObject(p_start->thread, INFINITE);
+    CloseHandle(p_start->thread);
+#else
+    pthread_join(p_start->thread, NULL);
+#endif
+
+    free(p_start);
+    p_thread->_handle = NULL;
+}
+
+sg_u32 sg_thread_hardware_concurrency(void)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (sg_u32)count : 1;
+#endif
+}
+
+void sg_thread_yield(void)
+{
+#if defined(_WIN32)
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+sg_u8 sg_mutex_init(sg_mutex* p_mutex)
+{
+#if defined(_WIN32)
+    SRWLOCK* p_lock = (SRWLOCK*)malloc(sizeof(SRWLOCK));
+    if (p_lock)
+        InitializeSRWLock(p_lock);
+#else
+    pthread_mutex_t* p_lock = (pthread_mutex_t*)malloc(sizeof(pthread_mutex_t));
+    if (p_lock && pthread_mutex_init(p_lock, NULL) != 0)
+    {
+        free(p_lock);
+        p_lock = NULL;
+    }
+#endif
+
+    p_mutex->_handle = p_lock;
+    return p_lock != NULL;
+}
+
+void sg_mutex_destroy(sg_mutex* p_mutex)
+{
+    if (p_mutex->_handle == NULL)
+        return;
+
+#if !defined(_WIN32)
+    pthread_mutex_destroy((pthread_mutex_t*)p_mutex->_handle);
+#endif
+
+    free(p_mutex->_handle);
+    p_mutex->_handle = NULL;
+}
+
+void sg_mutex_lock(sg_mutex* p_mutex)
+{
+#if defined(_WIN32)
+    AcquireSRWLockExclusive((SRWLOCK*)p_mutex->_handle);
+#else
+    pthread_mutex_lock((pthread_mutex_t*)p_mutex->_handle);
+#endif
+}
+
+void sg_mutex_unlock(sg_mutex* p_mutex)
+{
+#if defined(_WIN32)
+    ReleaseSRWLockExclusive((SRWLOCK*)p_mutex->_handle);
+#else
+    pthread_mutex_unlock((pthread_mutex_t*)p_mutex->_handle);
+#endif
+}
+
+sg_u8 sg_condition_init(sg_condition* p_condition)
+{
+#if defined(_WIN32)
+    CONDITION_VARIABLE* p_cond = (CONDITION_VARIABLE*)malloc(sizeof(CONDITION_VARIABLE));
+    if (p_cond)
+        InitializeConditionVariable(p_cond);
+#else
+    pthread_cond_t* p_cond = (pthread_cond_t*)malloc(sizeof(pthread_cond_t));
+    if (p_cond && pthread_cond_init(p_cond, NULL) != 0)
+    {
+        free(p_cond);
+        p_cond = NULL;
+    }
+#endif
+
+    p_condition->_handle = p_cond;
+    return p_cond != NULL;
+}
+
+void sg_condition_destroy(sg_condition* p_condition)
+{
+    if (p_condition->_handle == NULL)
+        return;
+
+#if !defined(_WIN32)
+    pthread_cond_destroy((pthread_cond_t*)p_condition->_handle);
+#endif
+
+    free(p_condition->_handle);
+    p_condition->_handle = NULL;
+}
+
+void sg_condition_wait(sg_condition* p_condition, sg_mutex* p_mutex)
+{
+#if defined(_WIN32)
+    SleepConditionVariableSRW((CONDITION_VARIABLE*)p_condition->_handle, (SRWLOCK*)p_mutex->_handle, INFINITE, 0);
+#else
+    pthread_cond_wait((pthread_cond_t*)p_condition->_handle, (pthread_mutex_t*)p_mutex->_handle);
+#endif
+}
+
+void sg_condition_signal(sg_condition* p_condition)
+{
+#if defined(_WIN32)
+    WakeConditionVariable((CONDITION_VARIABLE*)p_condition->_handle);
+#else
+    pthread_cond_signal((pthread_cond_t*)p_condition->_handle);
+#endif
+}
+
+void sg_condition_broadcast(sg_condition* p_condition)
+{
+#if defined(_WIN32)
+    WakeAllConditionVariable((CONDITION_VARIABLE*)p_condition->_handle);
+#else
+    pthread_cond_broadcast((pthread_cond_t*)p_condition->_handle);
+#endif
+}
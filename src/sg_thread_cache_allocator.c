@@ -0,0 +1,349 @@
+#include "sg_thread_cache_allocator.h"
+#include "sg_allocator.h"
+#include "sg_assert.h"
+#include <string.h>
+
+#if defined(_MSC_VER)
+#define SG_THREAD_LOCAL __declspec(thread)
+#else
+#define SG_THREAD_LOCAL __thread
+#endif
+
+typedef struct sg_thread_cache_header
+{
+    sg_thread_cache* _owner;
+    sg_u64 _size;
+} sg_thread_cache_header;
+
+typedef struct sg_thread_cache_slot
+{
+    sg_u32 _id;
+    sg_thread_cache* _cache;
+} sg_thread_cache_slot;
+
+// Allocator ids are never reused so a slot left behind by a destroyed allocator can not match a new one
+static sg_u32 s_next_id = 1;
+
+static SG_THREAD_LOCAL sg_thread_cache_slot s_slots[SG_THREAD_CACHE_SLOTS];
+static SG_THREAD_LOCAL sg_u32 s_slot_next;
+
+// Its address tells threads apart, a thread started after another exits may get the same one and adopt its caches
+static SG_THREAD_LOCAL sg_u8 s_thread_marker;
+
+static inline sg_u64 sg_block_size(sg_u32 class_idx)
+{
+    return (sg_u64)SG_THREAD_CACHE_MIN_BLOCK << class_idx;
+}
+
+static inline sg_u32 sg_class_index(sg_u64 size)
+{
+    sg_u32 class_idx = 0;
+    while (class_idx < SG_THREAD_CACHE_CLASS_COUNT && sg_block_size(class_idx) < size)
+        class_idx += 1;
+
+    return class_idx;
+}
+
+static inline sg_thread_cache_header* sg_header(void* p_allocation)
+{
+    return (sg_thread_cache_header*)((sg_u8*)p_allocation - SG_THREAD_CACHE_HEADER);
+}
+
+static inline void* sg_next(void* p_allocation)
+{
+    return *(void**)p_allocation;
+}
+
+static inline void sg_set_next(void* p_allocation, void* p_next)
+{
+    *(void**)p_allocation = p_next;
+}
+
+static void* sg_thread_cache_allocator_allocate_fn(sg_u64 size, void* p_user_data)
+{
+    return sg_thread_cache_allocator_allocate((sg_thread_cache_allocator*)p_user_data, size);
+}
+
+static void sg_thread_cache_allocator_free_fn(void* p_allocation, void* p_user_data)
+{
+    sg_thread_cache_allocator_free((sg_thread_cache_allocator*)p_user_data, p_allocation);
+}
+
+static void* sg_thread_cache_allocator_realloc_fn(void* p_allocation, sg_u64 size, void* p_user_data)
+{
+    return sg_thread_cache_allocator_realloc((sg_thread_cache_allocator*)p_user_data, p_allocation, size);
+}
+
+static sg_thread_cache* sg_thread_cache_get(sg_thread_cache_allocator* p_allocator)
+{
+    sg_u32 i = 0;
+    while (i < SG_THREAD_CACHE_SLOTS)
+    {
+        if (s_slots[i]._id == p_allocator->_id)
+            return s_slots[i]._cache;
+
+        i += 1;
+    }
+
+    /* 1. Look for the cache this thread already registered, it may have been pushed out of the slots
+       2. Otherwise create one and register it so destroy can find it
+       3. Take the next slot, a cache pushed out stays registered and is found again by step 1 */
+    sg_spinlock_lock(&p_allocator->_lock);
+    sg_thread_cache* p_cache = p_allocator->_caches;
+    while (p_cache && p_cache->_thread != &s_thread_marker)
+        p_cache = p_cache->_next;
+
+    if (p_cache == NULL)
+    {
+        sg_allocator* p_parent = p_allocator->p_parent;
+        p_cache = (sg_thread_cache*)p_parent->allocate(sizeof(sg_thread_cache), p_parent->p_user_data);
+        memset(p_cache, 0, sizeof(sg_thread_cache));
+        p_cache->_thread = &s_thread_marker;
+        p_cache->_next = p_allocator->_caches;
+        p_allocator->_caches = p_cache;
+    }
+    sg_spinlock_unlock(&p_allocator->_lock);
+
+    sg_thread_cache_slot* p_slot = s_slots + s_slot_next % SG_THREAD_CACHE_SLOTS;
+    p_slot->_id = p_allocator->_id;
+    p_slot->_cache = p_cache;
+    s_slot_next += 1;
+
+    return p_cache;
+}
+
+static void sg_thread_cache_release(sg_thread_cache_allocator* p_allocator, void* p_allocation)
+{
+    p_allocator->p_parent->free(sg_header(p_allocation), p_allocator->p_parent->p_user_data);
+}
+
+static void sg_thread_cache_release_list(sg_thread_cache_allocator* p_allocator, void* p_allocation)
+{
+    while (p_allocation)
+    {
+        void* p_next = sg_next(p_allocation);
+        sg_thread_cache_release(p_allocator, p_allocation);
+        p_allocation = p_next;
+    }
+}
+
+static void sg_thread_cache_push(sg_thread_cache_allocator* p_allocator, sg_thread_cache* p_cache, void* p_allocation)
+{
+    sg_u32 class_idx = sg_class_index(sg_header(p_allocation)->_size);
+    if (p_cache->_free_count[class_idx] >= p_allocator->_max_blocks)
+    {
+        sg_thread_cache_release(p_allocator, p_allocation);
+        return;
+    }
+
+    sg_set_next(p_allocation, p_cache->_free[class_idx]);
+    p_cache->_free[class_idx] = p_allocation;
+    p_cache->_free_count[class_idx] += 1;
+}
+
+static void sg_thread_cache_flush_pending(sg_thread_cache* p_cache)
+{
+    if (p_cache->_pending_head == NULL)
+        return;
+
+    // Splice the whole batch onto the owner's stack
+    sg_thread_cache* p_owner = p_cache->_pending_owner;
+    void* p_head = sg_atomic_load_ptr(&p_owner->_remote);
+    while (1)
+    {
+        sg_set_next(p_cache->_pending_tail, p_head);
+        void* p_prev = sg_atomic_cas_ptr(&p_owner->_remote, p_head, p_cache->_pending_head);
+        if (p_prev == p_head)
+            break;
+
+        p_head = p_prev;
+    }
+
+    p_cache->_pending_owner = NULL;
+    p_cache->_pending_head = NULL;
+    p_cache->_pending_tail = NULL;
+    p_cache->_pending_count = 0;
+}
+
+static void sg_thread_cache_drain_remote(sg_thread_cache_allocator* p_allocator, sg_thread_cache* p_cache)
+{
+    void* p_allocation = sg_atomic_exchange_ptr(&p_cache->_remote, NULL);
+    while (p_allocation)
+    {
+        void* p_next = sg_next(p_allocation);
+        sg_thread_cache_push(p_allocator, p_cache, p_allocation);
+        p_allocation = p_next;
+    }
+}
+
+sg_thread_cache_allocator sg_thread_cache_allocator_create(sg_u32 max_blocks, sg_allocator* p_parent)
+{
+    if (p_parent == NULL)
+        p_parent = &s_allocator_default;
+
+    if (max_blocks == 0)
+        max_blocks = SG_THREAD_CACHE_MAX_BLOCKS;
+
+    sg_thread_cache_allocator allocator;
+    allocator.p_parent = p_parent;
+    allocator._caches = NULL;
+    allocator._lock = 0;
+    allocator._id = sg_atomic_fetch_add_u32(&s_next_id, 1);
+    allocator._max_blocks = max_blocks;
+    return allocator;
+}
+
+void sg_thread_cache_allocator_destroy(sg_thread_cache_allocator* p_allocator)
+{
+    // Every cached block sits in exactly one free list, pending batch or remote stack
+    sg_thread_cache* p_cache = p_allocator->_caches;
+    while (p_cache)
+    {
+        sg_thread_cache* p_next = p_cache->_next;
+
+        sg_u32 i = 0;
+        while (i < SG_THREAD_CACHE_CLASS_COUNT)
+        {
+            sg_thread_cache_release_list(p_allocator, p_cache->_free[i]);
+            i += 1;
+        }
+
+        sg_thread_cache_release_list(p_allocator, p_cache->_pending_head);
+        sg_thread_cache_release_list(p_allocator, p_cache->_remote);
+
+        p_allocator->p_parent->free(p_cache, p_allocator->p_parent->p_user_data);
+        p_cache = p_next;
+    }
+
+    p_allocator->p_parent = NULL;
+    p_allocator->_caches = NULL;
+    p_allocator->_lock = 0;
+    p_allocator->_id = 0;
+    p_allocator->_max_blocks = 0;
+}
+
+sg_allocator sg_thread_cache_allocator_allocator(sg_thread_cache_allocator* p_allocator)
+{
+    sg_allocator allocator =
+    {
+        &sg_thread_cache_allocator_allocate_fn,
+        &sg_thread_cache_allocator_free_fn,
+        &sg_thread_cache_allocator_realloc_fn,
+        p_allocator,
+        NULL,
+        NULL,
+        NULL
+    };
+
+    return allocator;
+}
+
+void* sg_thread_cache_allocator_allocate(sg_thread_cache_allocator* p_allocator, sg_u64 size)
+{
+    sg_allocator* p_parent = p_allocator->p_parent;
+    sg_u32 class_idx = sg_class_index(size);
+    sg_thread_cache_header* p_header = NULL;
+
+    /* 1. Oversized requests go to the parent without an owner
+       2. Pop the thread's free list, refilling it from the remote stack when empty
+       3. Otherwise take a new block from the parent */
+    if (class_idx == SG_THREAD_CACHE_CLASS_COUNT)
+    {
+        p_header = (sg_thread_cache_header*)p_parent->allocate(SG_THREAD_CACHE_HEADER + size, p_parent->p_user_data);
+        p_header->_owner = NULL;
+        p_header->_size = size;
+        return (sg_u8*)p_header + SG_THREAD_CACHE_HEADER;
+    }
+
+    sg_thread_cache* p_cache = sg_thread_cache_get(p_allocator);
+    if (p_cache->_free[class_idx] == NULL && sg_atomic_load_ptr(&p_cache->_remote) != NULL)
+        sg_thread_cache_drain_remote(p_allocator, p_cache);
+
+    void* p_allocation = p_cache->_free[class_idx];
+    if (p_allocation)
+    {
+        p_cache->_free[class_idx] = sg_next(p_allocation);
+        p_cache->_free_count[class_idx] -= 1;
+        p_header = sg_header(p_allocation);
+    }
+    else
+    {
+        p_header = (sg_thread_cache_header*)p_parent->allocate(SG_THREAD_CACHE_HEADER + sg_block_size(class_idx), p_parent->p_user_data);
+        p_header->_owner = p_cache;
+    }
+
+    p_header->_size = size;
+    return (sg_u8*)p_header + SG_THREAD_CACHE_HEADER;
+}
+
+void sg_thread_cache_allocator_free(sg_thread_cache_allocator* p_allocator, void* p_allocation)
+{
+    if (p_allocation == NULL)
+        return;
+
+    sg_thread_cache* p_owner = sg_header(p_allocation)->_owner;
+    if (p_owner == NULL)
+    {
+        sg_thread_cache_release(p_allocator, p_allocation);
+        return;
+    }
+
+    sg_thread_cache* p_cache = sg_thread_cache_get(p_allocator);
+    if (p_owner == p_cache)
+    {
+        sg_thread_cache_push(p_allocator, p_cache, p_allocation);
+        return;
+    }
+
+    // Batches hold blocks of a single owner
+    if (p_cache->_pending_owner != p_owner)
+    {
+        sg_thread_cache_flush_pending(p_cache);
+        p_cache->_pending_owner = p_owner;
+        p_cache->_pending_tail = p_allocation;
+    }
+
+    sg_set_next(p_allocation, p_cache->_pending_head);
+    p_cache->_pending_head = p_allocation;
+    p_cache->_pending_count += 1;
+
+    if (p_cache->_pending_count == SG_THREAD_CACHE_REMOTE_BATCH)
+        sg_thread_cache_flush_pending(p_cache);
+}
+
+void* sg_thread_cache_allocator_realloc(sg_thread_cache_allocator* p_allocator, void* p_allocation, sg_u64 size)
+{
+    if (p_allocation == NULL)
+        return sg_thread_cache_allocator_allocate(p_allocator, size);
+
+    /* 1. Blocks that stay in their class keep their address
+       2. Oversized blocks that stay oversized are resized by the parent
+       3. Anything else moves between classes */
+    sg_thread_cache_header* p_header = sg_header(p_allocation);
+    sg_u64 old_size = p_header->_size;
+    sg_u32 class_idx = sg_class_index(size);
+    if (class_idx == sg_class_index(old_size))
+    {
+        if (class_idx == SG_THREAD_CACHE_CLASS_COUNT)
+        {
+            sg_allocator* p_parent = p_allocator->p_parent;
+            p_header = (sg_thread_cache_header*)p_parent->realloc(p_header, SG_THREAD_CACHE_HEADER + size, p_parent->p_user_data);
+        }
+
+        p_header->_size = size;
+        return (sg_u8*)p_header + SG_THREAD_CACHE_HEADER;
+    }
+
+    void* p_reallocation = sg_thread_cache_allocator_allocate(p_allocator, size);
+    memcpy_s(p_reallocation, size, p_allocation, old_size < size ? old_size : size);
+    sg_thread_cache_allocator_free(p_allocator, p_allocation);
+
+    return p_reallocation;
+}
+
+void sg_thread_cache_allocator_flush(sg_thread_cache_allocator* p_allocator)
+{
+    sg_thread_cache* p_cache = sg_thread_cache_get(p_allocator);
+    sg_thread_cache_flush_pending(p_cache);
+    sg_thread_cache_drain_remote(p_allocator, p_cache);
+}
@@ -0,0 +1,294 @@
+#include "sg_tracking_allocator.h"
+#include "sg_allocator.h"
+#include "sg_assert.h"
+#include "sg_atomic.h"
+#include <string.h>
+
+typedef struct sg_tracking_header
+{
+    sg_u64 _size;
+    sg_u32 _offset;
+    sg_u8 _tag;
+    sg_u8 _aligned;
+    sg_u8 _pad[2];
+} sg_tracking_header;
+
+static inline sg_tracking_header* sg_header(void* p_allocation)
+{
+    return (sg_tracking_header*)((sg_u8*)p_allocation - SG_TRACKING_ALLOCATOR_HEADER);
+}
+
+static inline sg_u32 sg_bucket(sg_u64 size)
+{
+    sg_u32 bucket = 0;
+    while (size > 1 && bucket < SG_TRACKING_ALLOCATOR_BUCKETS - 1)
+    {
+        size >>= 1;
+        bucket += 1;
+    }
+
+    return bucket;
+}
+
+static void sg_stats_live(sg_allocation_stats* p_stats, sg_u64 delta)
+{
+    // Deltas wrap for shrinking so the sum stays exact
+    sg_u64 live = sg_atomic_fetch_add_u64(&p_stats->live_bytes, delta) + delta;
+    sg_u64 peak = sg_atomic_load_u64(&p_stats->peak_bytes);
+    while (live > peak && live < (1ull << 63))
+    {
+        sg_u64 prev = sg_atomic_cas_u64(&p_stats->peak_bytes, peak, live);
+        if (prev == peak)
+            break;
+
+        peak = prev;
+    }
+}
+
+static void sg_stats_allocate(sg_allocation_stats* p_stats, sg_u64 size)
+{
+    sg_stats_live(p_stats, size);
+    sg_atomic_fetch_add_u64(&p_stats->total_bytes, size);
+    sg_atomic_fetch_add_u64(&p_stats->allocations, 1);
+    sg_atomic_fetch_add_u64(&p_stats->histogram[sg_bucket(size)], 1);
+}
+
+static void sg_stats_reallocate(sg_allocation_stats* p_stats, sg_u64 old_size, sg_u64 size)
+{
+    sg_stats_live(p_stats, size - old_size);
+    sg_atomic_fetch_add_u64(&p_stats->total_bytes, size);
+    sg_atomic_fetch_add_u64(&p_stats->reallocations, 1);
+    sg_atomic_fetch_add_u64(&p_stats->histogram[sg_bucket(size)], 1);
+}
+
+static void sg_stats_free(sg_allocation_stats* p_stats, sg_u64 size)
+{
+    sg_atomic_fetch_add_u64(&p_stats->live_bytes, 0ull - size);
+    sg_atomic_fetch_add_u64(&p_stats->frees, 1);
+}
+
+static void* sg_tracking_place(sg_tracking_tag* p_tag, sg_u8* p_raw, sg_u64 size, sg_u32 offset, sg_u8 aligned)
+{
+    if (p_raw == NULL)
+        return NULL;
+
+    sg_u8* p_allocation = p_raw + offset;
+    sg_tracking_header* p_header = sg_header(p_allocation);
+    p_header->_size = size;
+    p_header->_offset = offset;
+    p_header->_tag = (sg_u8)(p_tag - p_tag->_owner->_tags);
+    p_header->_aligned = aligned;
+
+    return p_allocation;
+}
+
+static void* sg_tracking_allocate_fn(sg_u64 size, void* p_user_data)
+{
+    sg_tracking_tag* p_tag = (sg_tracking_tag*)p_user_data;
+    sg_allocator* p_parent = p_tag->_owner->p_parent;
+
+    sg_u8* p_raw = (sg_u8*)p_parent->allocate(SG_TRACKING_ALLOCATOR_HEADER + size, p_parent->p_user_data);
+    if (p_raw)
+    {
+        sg_stats_allocate(&p_tag->_stats, size);
+        sg_stats_allocate(&p_tag->_owner->_total, size);
+    }
+
+    return sg_tracking_place(p_tag, p_raw, size, SG_TRACKING_ALLOCATOR_HEADER, 0);
+}
+
+static void* sg_tracking_allocate_aligned_fn(sg_u64 size, sg_u64 alignment, void* p_user_data)
+{
+    sg_tracking_tag* p_tag = (sg_tracking_tag*)p_user_data;
+    sg_allocator* p_parent = p_tag->_owner->p_parent;
+
+    // A whole alignment unit in front keeps the payload aligned
+    sg_u32 offset = alignment > SG_TRACKING_ALLOCATOR_HEADER ? (sg_u32)alignment : SG_TRACKING_ALLOCATOR_HEADER;
+    sg_u8* p_raw = (sg_u8*)sg_allocator_allocate_aligned(p_parent, offset + size, alignment);
+    if (p_raw)
+    {
+        sg_stats_allocate(&p_tag->_stats, size);
+        sg_stats_allocate(&p_tag->_owner->_total, size);
+    }
+
+    return sg_tracking_place(p_tag, p_raw, size, offset, 1);
+}
+
+static void sg_tracking_free_fn(void* p_allocation, void* p_user_data)
+{
+    if (p_allocation == NULL)
+        return;
+
+    // Frees count against the tag that allocated the block
+    sg_tracking_allocator* p_tracker = ((sg_tracking_tag*)p_user_data)->_owner;
+    sg_tracking_header* p_header = sg_header(p_allocation);
+    sg_stats_free(&p_tracker->_tags[p_header->_tag]._stats, p_header->_size);
+    sg_stats_free(&p_tracker->_total, p_header->_size);
+
+    sg_u8* p_raw = (sg_u8*)p_allocation - p_header->_offset;
+    if (p_header->_aligned)
+        sg_allocator_free_aligned(p_tracker->p_parent, p_raw);
+    else
+        p_tracker->p_parent->free(p_raw, p_tracker->p_parent->p_user_data);
+}
+
+static void* sg_tracking_realloc_fn(void* p_allocation, sg_u64 size, void* p_user_data)
+{
+    if (p_allocation == NULL)
+        return sg_tracking_allocate_fn(size, p_user_data);
+
+    sg_tracking_allocator* p_tracker = ((sg_tracking_tag*)p_user_data)->_owner;
+    sg_tracking_header* p_header = sg_header(p_allocation);
+    sg_tracking_tag* p_tag = p_tracker->_tags + p_header->_tag;
+    sg_u64 old_size = p_header->_size;
+    SG_ASSERT(!p_header->_aligned);
+
+    sg_u8* p_raw = (sg_u8*)p_allocation - SG_TRACKING_ALLOCATOR_HEADER;
+    p_raw = (sg_u8*)p_tracker->p_parent->realloc(p_raw, SG_TRACKING_ALLOCATOR_HEADER + size, p_tracker->p_parent->p_user_data);
+    if (p_raw)
+    {
+        sg_stats_reallocate(&p_tag->_stats, old_size, size);
+        sg_stats_reallocate(&p_tracker->_total, old_size, size);
+    }
+
+    return sg_tracking_place(p_tag, p_raw, size, SG_TRACKING_ALLOCATOR_HEADER, 0);
+}
+
+static void* sg_tracking_realloc_aligned_fn(void* p_allocation, sg_u64 size, sg_u64 alignment, void* p_user_data)
+{
+    if (p_allocation == NULL)
+        return sg_tracking_allocate_aligned_fn(size, alignment, p_user_data);
+
+    sg_tracking_allocator* p_tracker = ((sg_tracking_tag*)p_user_data)->_owner;
+    sg_tracking_header* p_header = sg_header(p_allocation);
+    sg_tracking_tag* p_tag = p_tracker->_tags + p_header->_tag;
+    sg_u64 old_size = p_header->_size;
+    sg_u32 offset = p_header->_offset;
+    SG_ASSERT(p_header->_aligned && (offset == alignment || (alignment <= SG_TRACKING_ALLOCATOR_HEADER && offset == SG_TRACKING_ALLOCATOR_HEADER)));
+
+    sg_u8* p_raw = (sg_u8*)p_allocation - offset;
+    p_raw = (sg_u8*)sg_allocator_realloc_aligned(p_tracker->p_parent, p_raw, offset + size, alignment);
+    if (p_raw)
+    {
+        sg_stats_reallocate(&p_tag->_stats, old_size, size);
+        sg_stats_reallocate(&p_tracker->_total, old_size, size);
+    }
+
+    return sg_tracking_place(p_tag, p_raw, size, offset, 1);
+}
+
+static sg_allocation_stats sg_stats_load(sg_allocation_stats* p_stats)
+{
+    sg_allocation_stats stats;
+    stats.live_bytes = sg_atomic_load_u64(&p_stats->live_bytes);
+    stats.peak_bytes = sg_atomic_load_u64(&p_stats->peak_bytes);
+    stats.total_bytes = sg_atomic_load_u64(&p_stats->total_bytes);
+    stats.allocations = sg_atomic_load_u64(&p_stats->allocations);
+    stats.reallocations = sg_atomic_load_u64(&p_stats->reallocations);
+    stats.frees = sg_atomic_load_u64(&p_stats->frees);
+
+    sg_u32 i = 0;
+    while (i < SG_TRACKING_ALLOCATOR_BUCKETS)
+    {
+        stats.histogram[i] = sg_atomic_load_u64(&p_stats->histogram[i]);
+        i += 1;
+    }
+
+    return stats;
+}
+
+static void sg_stats_dump(const char* name, sg_allocation_stats* p_stats, FILE* p_file)
+{
+    sg_allocation_stats stats = sg_stats_load(p_stats);
+    fprintf(p_file, "%s: live %llu peak %llu total %llu allocations %llu reallocations %llu frees %llu\n",
+        name,
+        (unsigned long long)stats.live_bytes,
+        (unsigned long long)stats.peak_bytes,
+        (unsigned long long)stats.total_bytes,
+        (unsigned long long)stats.allocations,
+        (unsigned long long)stats.reallocations,
+        (unsigned long long)stats.frees);
+
+    sg_u32 i = 0;
+    while (i < SG_TRACKING_ALLOCATOR_BUCKETS)
+    {
+        if (stats.histogram[i])
+            fprintf(p_file, "    %llu+: %llu\n", 1ull << i, (unsigned long long)stats.histogram[i]);
+
+        i += 1;
+    }
+}
+
+sg_tracking_allocator sg_tracking_allocator_create(sg_allocator* p_parent)
+{
+    if (p_parent == NULL)
+        p_parent = &s_allocator_default;
+
+    sg_tracking_allocator tracker;
+    memset(&tracker, 0, sizeof(sg_tracking_allocator));
+    tracker.p_parent = p_parent;
+    tracker._tags[SG_TRACKING_ALLOCATOR_TAG_NONE]._name = "untagged";
+    tracker._tag_count = 1;
+    return tracker;
+}
+
+void sg_tracking_allocator_destroy(sg_tracking_allocator* p_tracker)
+{
+    memset(p_tracker, 0, sizeof(sg_tracking_allocator));
+}
+
+sg_u32 sg_tracking_allocator_add_tag(sg_tracking_allocator* p_tracker, const char* name)
+{
+    if (p_tracker->_tag_count == SG_TRACKING_ALLOCATOR_MAX_TAGS)
+        return SG_TRACKING_ALLOCATOR_TAG_NONE;
+
+    sg_u32 tag = p_tracker->_tag_count;
+    p_tracker->_tags[tag]._name = name;
+    p_tracker->_tag_count += 1;
+    return tag;
+}
+
+sg_allocator sg_tracking_allocator_allocator(sg_tracking_allocator* p_tracker, sg_u32 tag)
+{
+    SG_ASSERT(tag < p_tracker->_tag_count);
+
+    // The tracker is returned by value from create so the back pointer is set on first use
+    sg_tracking_tag* p_tag = p_tracker->_tags + tag;
+    p_tag->_owner = p_tracker;
+
+    sg_allocator allocator =
+    {
+        &sg_tracking_allocate_fn,
+        &sg_tracking_free_fn,
+        &sg_tracking_realloc_fn,
+        p_tag,
+        &sg_tracking_allocate_aligned_fn,
+        &sg_tracking_free_fn,
+        &sg_tracking_realloc_aligned_fn
+    };
+
+    return allocator;
+}
+
+sg_allocation_stats sg_tracking_allocator_stats(sg_tracking_allocator* p_tracker, sg_u32 tag)
+{
+    SG_ASSERT(tag < p_tracker->_tag_count);
+    return sg_stats_load(&p_tracker->_tags[tag]._stats);
+}
+
+sg_allocation_stats sg_tracking_allocator_total(sg_tracking_allocator* p_tracker)
+{
+    return sg_stats_load(&p_tracker->_total);
+}
+
+void sg_tracking_allocator_dump(sg_tracking_allocator* p_tracker, FILE* p_file)
+{
+    sg_stats_dump("total", &p_tracker->_total, p_file);
+
+    sg_u32 i = 0;
+    while (i < p_tracker->_tag_count)
+    {
+        sg_stats_dump(p_tracker->_tags[i]._name, &p_tracker->_tags[i]._stats, p_file);
+        i += 1;
+    }
+}
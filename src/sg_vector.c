@@ -1,26 +1,81 @@
 #include "sg_vector.h"
 #include "sg_allocator.h"
 #include "sg_assert.h"
+#include "sg_cpu.h"
+#include "sg_snapshot.h"
+#include <string.h>
 
 static inline void memclear(void* p_data, sg_u64 size)
 {
-    memset(p_data, 0U, size);
+    sg_cpu_memclear(p_data, size);
+}
+
+// Reserved buffers commit whole pages, elements past the reservation do not count
+static inline sg_u32 sg_vector_buffer_capacity(sg_buffer* p_buffer, sg_u32 stride)
+{
+    sg_u64 size = p_buffer->size;
+    if (p_buffer->reserved && size > p_buffer->reserved)
+        size = p_buffer->reserved;
+
+    return (sg_u32)(size / stride);
 }
 
 sg_vector sg_vector_create(sg_u32 size, sg_u32 stride, sg_allocator* p_allocator)
+{
+    return sg_vector_create_aligned(size, stride, 0, p_allocator);
+}
+
+sg_vector sg_vector_create_aligned(sg_u32 size, sg_u32 stride, sg_u64 alignment, sg_allocator* p_allocator)
 {
     SG_ASSERT(stride != 0);
 
-    sg_buffer buffer = sg_buffer_create(stride * size, p_allocator);
+    sg_buffer buffer = sg_buffer_create_aligned((sg_u64)stride * size, alignment, p_allocator);
 
     if (size != 0)
-        memclear(buffer.allocation, stride * size);
+        memclear(buffer.allocation, (sg_u64)stride * size);
 
     sg_vector vector;
     vector._buffer = buffer; 
     vector._capacity = buffer.size / stride;
     vector._size = size;
     vector._stride = stride;  
+    vector._growth = SG_VECTOR_GROWTH_FACTOR;
+    vector._growth_amount = SG_VECTOR_GROWTH_DEFAULT_AMOUNT;
+    return vector;
+}
+
+sg_vector sg_vector_create_reserved(sg_u32 size, sg_u32 stride, sg_u32 max_size)
+{
+    SG_ASSERT(stride != 0);
+
+    // Fresh pages read as zero so there is nothing to clear
+    sg_buffer buffer = sg_buffer_create_reserved((sg_u64)stride * size, (sg_u64)stride * max_size);
+
+    // A commit that failed leaves the vector empty
+    sg_vector vector;
+    vector._buffer = buffer;
+    vector._capacity = sg_vector_buffer_capacity(&buffer, stride);
+    vector._size = vector._capacity < size ? 0 : size;
+    vector._stride = stride;
+    vector._growth = SG_VECTOR_GROWTH_FACTOR;
+    vector._growth_amount = SG_VECTOR_GROWTH_DEFAULT_AMOUNT;
+    return vector;
+}
+
+sg_vector sg_vector_create_mapped(const char* path, sg_u32 stride, sg_u8 copy_on_write, sg_u32 advice)
+{
+    SG_ASSERT(stride != 0);
+
+    sg_buffer buffer = sg_buffer_create_mapped(path, copy_on_write, advice);
+
+    // A trailing partial element is left out
+    sg_vector vector;
+    vector._buffer = buffer;
+    vector._capacity = (sg_u32)(buffer.size / stride);
+    vector._size = vector._capacity;
+    vector._stride = stride;
+    vector._growth = SG_VECTOR_GROWTH_FACTOR;
+    vector._growth_amount = SG_VECTOR_GROWTH_DEFAULT_AMOUNT;
     return vector;
 }
 
@@ -32,31 +87,85 @@ void sg_vector_destroy(sg_vector* p_vector)
     p_vector->_stride = 0;
 }
 
-void sg_vector_reserve(sg_vector* p_vector, sg_u32 size)
+// Returns 0 when the buffer can not hold size elements, the vector is left as it was
+static sg_u8 sg_vector_grow(sg_vector* p_vector, sg_u64 size)
+{
+    sg_u64 capacity = p_vector->_capacity;
+    if (p_vector->_growth == SG_VECTOR_GROWTH_INCREMENT)
+        capacity += (sg_u64)p_vector->_growth_amount;
+    else
+        capacity = (sg_u64)(capacity * p_vector->_growth_amount);
+
+    if (capacity < size)
+        capacity = size;
+
+    if (p_vector->_growth == SG_VECTOR_GROWTH_PAGE)
+        capacity = sg_virtual_memory_round_up(capacity * p_vector->_stride) / p_vector->_stride;
+
+    if (capacity > 0xFFFFFFFFull)
+        capacity = 0xFFFFFFFFull;
+
+    // Reserved vectors stop at max_size rather than failing a step that overshoots it
+    if (p_vector->_buffer.reserved && capacity * p_vector->_stride > p_vector->_buffer.reserved)
+        capacity = p_vector->_buffer.reserved / p_vector->_stride;
+
+    if (capacity < size)
+        return 0;
+
+    sg_vector_reserve(p_vector, (sg_u32)capacity);
+    return p_vector->_capacity >= size;
+}
+
+sg_u8 sg_vector_reserve(sg_vector* p_vector, sg_u32 size)
 {
     if (p_vector->_capacity < size)
     {
-        sg_buffer_resize(&p_vector->_buffer, size * p_vector->_stride);
-        p_vector->_capacity = p_vector->_buffer.size / p_vector->_stride;
+        sg_buffer_resize(&p_vector->_buffer, (sg_u64)size * p_vector->_stride);
+        p_vector->_capacity = sg_vector_buffer_capacity(&p_vector->_buffer, p_vector->_stride);
     }
+
+    return p_vector->_capacity >= size;
 }
 
-void sg_vector_resize(sg_vector* p_vector, sg_u32 size)
+sg_u8 sg_vector_resize(sg_vector* p_vector, sg_u32 size)
 {
-    sg_vector_reserve(p_vector, size);
+    if (!sg_vector_reserve(p_vector, size))
+        return 0;
+
     p_vector->_size = size;
+    return 1;
+}
+
+void sg_vector_set_growth(sg_vector* p_vector, sg_u32 growth, sg_f32 amount)
+{
+    SG_ASSERT(growth <= SG_VECTOR_GROWTH_PAGE);
+    SG_ASSERT(growth == SG_VECTOR_GROWTH_INCREMENT ? amount >= 1.0f : amount > 1.0f);
+
+    p_vector->_growth = growth;
+    p_vector->_growth_amount = amount;
+}
+
+void sg_vector_shrink_to_fit(sg_vector* p_vector)
+{
+    // Reserved buffers keep whole pages so capacity can stay above size
+    sg_buffer_shrink(&p_vector->_buffer, (sg_u64)p_vector->_size * p_vector->_stride);
+    p_vector->_capacity = sg_vector_buffer_capacity(&p_vector->_buffer, p_vector->_stride);
+}
+
+void sg_vector_clear_and_release(sg_vector* p_vector)
+{
+    p_vector->_size = 0;
+    sg_vector_shrink_to_fit(p_vector);
 }
 
 void* sg_vector_emplace(sg_vector* p_vector)
 {
-    sg_u32 byte_offset = p_vector->_size * p_vector->_stride;
+    sg_u64 byte_offset = (sg_u64)p_vector->_size * p_vector->_stride;
     sg_u64 size = p_vector->_size + 1;
-    if (p_vector->_capacity < size)
-    {
-        sg_vector_reserve(p_vector, size * 2ull);
-    }
+    if (p_vector->_capacity < size && !sg_vector_grow(p_vector, size))
+        return NULL;
 
-    p_vector->_size = size;
+    p_vector->_size = (sg_u32)size;
 
     return &p_vector->_buffer.allocation[byte_offset];
 }
@@ -64,13 +173,11 @@ void* sg_vector_emplace(sg_vector* p_vector)
 sg_u32 sg_vector_push(sg_vector* p_vector, void* p_element)
 {
     sg_u32 index = p_vector->_size;
-    sg_u32 byte_offset = index * p_vector->_stride;
+    sg_u64 byte_offset = (sg_u64)index * p_vector->_stride;
     sg_u64 size = p_vector->_size + 1;
-    if (p_vector->_capacity < size)
-    {
-        sg_vector_reserve(p_vector, size * 2ull);
-    }
-    
+    if (p_vector->_capacity < size && !sg_vector_grow(p_vector, size))
+        return SG_VECTOR_IDX_NULL;
+
     memcpy_s(p_vector->_buffer.allocation + byte_offset, p_vector->_stride, p_element, p_vector->_stride);
 
     p_vector->_size = size;
@@ -78,20 +185,97 @@ sg_u32 sg_vector_push(sg_vector* p_vector, void* p_element)
     return index;
 }
 
+static inline sg_u8 sg_vector_contains(sg_vector* p_vector, const sg_u8* p_data)
+{
+    const sg_u8* p_begin = p_vector->_buffer.allocation;
+    return p_begin != NULL && p_data >= p_begin && p_data < p_begin + p_vector->_buffer.size;
+}
+
+sg_u32 sg_vector_append(sg_vector* p_vector, sg_slice* p_slice)
+{
+    SG_ASSERT(p_slice->_stride == p_vector->_stride);
+
+    sg_u32 index = p_vector->_size;
+    sg_u64 size = (sg_u64)p_vector->_size + p_slice->_count;
+    sg_u64 byte_size = (sg_u64)p_slice->_count * p_vector->_stride;
+
+    // Growth moves the allocation, a slice of this vector is found again by its offset
+    const sg_u8* p_source = p_slice->_data;
+    sg_u8 aliased = sg_vector_contains(p_vector, p_source);
+    sg_u64 source_offset = aliased ? (sg_u64)(p_source - p_vector->_buffer.allocation) : 0;
+
+    if (p_vector->_capacity < size && !sg_vector_grow(p_vector, size))
+        return SG_VECTOR_IDX_NULL;
+
+    if (aliased)
+        p_source = p_vector->_buffer.allocation + source_offset;
+
+    if (byte_size)
+        memcpy_s(p_vector->_buffer.allocation + (sg_u64)index * p_vector->_stride, byte_size, p_source, byte_size);
+
+    p_vector->_size = (sg_u32)size;
+
+    return index;
+}
+
+sg_u8 sg_vector_insert_range(sg_vector* p_vector, sg_u32 index, sg_slice* p_slice)
+{
+    SG_ASSERT(index <= p_vector->_size);
+    SG_ASSERT(p_slice->_stride == p_vector->_stride);
+    SG_ASSERT(p_slice->_count == 0 || !sg_vector_contains(p_vector, p_slice->_data));
+
+    sg_u64 size = (sg_u64)p_vector->_size + p_slice->_count;
+    if (p_vector->_capacity < size && !sg_vector_grow(p_vector, size))
+        return 0;
+
+    sg_u64 byte_offset = (sg_u64)index * p_vector->_stride;
+    sg_u64 byte_size = (sg_u64)p_slice->_count * p_vector->_stride;
+    sg_u64 tail_size = (sg_u64)(p_vector->_size - index) * p_vector->_stride;
+    if (byte_size == 0)
+        return 1;
+
+    sg_u8* p_data = p_vector->_buffer.allocation + byte_offset;
+    memmove(p_data + byte_size, p_data, tail_size);
+    memcpy_s(p_data, byte_size, p_slice->_data, byte_size);
+
+    p_vector->_size = (sg_u32)size;
+    return 1;
+}
+
 void sg_vector_erase(sg_vector* p_vector, sg_u32 index)
+{
+    sg_vector_erase_range(p_vector, index, 1);
+}
+
+void sg_vector_erase_range(sg_vector* p_vector, sg_u32 index, sg_u32 count)
+{
+    SG_ASSERT(index <= p_vector->_size && count <= p_vector->_size - index);
+
+    if (count == 0)
+        return;
+
+    sg_u64 byte_offset = (sg_u64)index * p_vector->_stride;
+    sg_u64 byte_size = (sg_u64)count * p_vector->_stride;
+    sg_u64 tail_size = (sg_u64)(p_vector->_size - index - count) * p_vector->_stride;
+
+    sg_u8* p_data = p_vector->_buffer.allocation + byte_offset;
+    memmove(p_data, p_data + byte_size, tail_size);
+
+    p_vector->_size -= count;
+}
+
+void sg_vector_erase_swap(sg_vector* p_vector, sg_u32 index)
 {
     SG_ASSERT(index < p_vector->_size);
 
-    sg_u32 i = index + 1;
-    while (i < p_vector->_size)
+    sg_u32 last = p_vector->_size - 1;
+    if (index != last)
     {
-        sg_u32 curr = i * p_vector->_stride;
-        sg_u32 prev = (i - 1) * p_vector->_stride;
-        memcpy_s(p_vector->_buffer.allocation + prev, p_vector->_stride, p_vector->_buffer.allocation + curr, p_vector->_stride);
-        ++i;
+        sg_u8* p_data = p_vector->_buffer.allocation;
+        memcpy_s(p_data + (sg_u64)index * p_vector->_stride, p_vector->_stride, p_data + (sg_u64)last * p_vector->_stride, p_vector->_stride);
     }
 
-    p_vector->_size -= 1;
+    p_vector->_size = last;
 }
 
 sg_u32 sg_vector_size(sg_vector* p_vector)
@@ -108,7 +292,7 @@ void* sg_vector_data(sg_vector* p_vector, sg_u32 index)
 {
     SG_ASSERT(p_vector->_size > index);
 
-    return sg_buffer_data(&p_vector->_buffer, index * p_vector->_stride);
+    return sg_buffer_data(&p_vector->_buffer, (sg_u64)index * p_vector->_stride);
 }
 
 void* sg_vector_back(sg_vector* p_vector)
@@ -116,7 +300,7 @@ void* sg_vector_back(sg_vector* p_vector)
     SG_ASSERT(p_vector->_buffer.allocation);
     SG_ASSERT(p_vector->_size > 0);
 
-    return sg_buffer_data(&p_vector->_buffer, (p_vector->_size - 1) * p_vector->_stride);
+    return sg_buffer_data(&p_vector->_buffer, (sg_u64)(p_vector->_size - 1) * p_vector->_stride);
 }
 
 sg_slice sg_vector_to_slice(sg_vector* p_vector, sg_u32 offset, sg_u32 size)
@@ -126,3 +310,58 @@ sg_slice sg_vector_to_slice(sg_vector* p_vector, sg_u32 offset, sg_u32 size)
 
     return sg_slice_make(p_vector->_buffer.allocation, offset, size, p_vector->_stride);
 }
+
+sg_u8 sg_vector_save(sg_vector* p_vector, const char* path)
+{
+    sg_snapshot_header header;
+    memset(&header, 0, sizeof(sg_snapshot_header));
+    header.kind = SG_SNAPSHOT_KIND_VECTOR;
+    header.params[0] = p_vector->_size;
+    header.params[1] = p_vector->_stride;
+
+    const void* parts[1] = { p_vector->_buffer.allocation };
+    sg_u64 sizes[1] = { (sg_u64)p_vector->_size * p_vector->_stride };
+    return sg_snapshot_save(path, &header, parts, sizes, 1);
+}
+
+sg_u8 sg_vector_load(sg_vector* p_vector, const char* path, sg_allocator* p_allocator)
+{
+    sg_snapshot_reader reader;
+    sg_snapshot_header header;
+    if (!sg_snapshot_open(&reader, path, SG_SNAPSHOT_KIND_VECTOR, &header))
+        return 0;
+
+    // The params are checked against the payload before anything is allocated from them
+    sg_u32 size = header.params[0];
+    sg_u32 stride = header.params[1];
+    if (stride == 0 || (sg_u64)size * stride != header.payload_size)
+    {
+        sg_snapshot_close(&reader, &header);
+        return 0;
+    }
+
+    // Elements are read straight into the buffer so there is nothing to clear
+    sg_vector vector;
+    vector._buffer = sg_buffer_create((sg_u64)size * stride, p_allocator);
+    if (size != 0 && vector._buffer.allocation == NULL)
+    {
+        sg_snapshot_close(&reader, &header);
+        return 0;
+    }
+
+    vector._capacity = size;
+    vector._size = size;
+    vector._stride = stride;
+    vector._growth = SG_VECTOR_GROWTH_FACTOR;
+    vector._growth_amount = SG_VECTOR_GROWTH_DEFAULT_AMOUNT;
+
+    sg_u8 loaded = sg_snapshot_read(&reader, vector._buffer.allocation, (sg_u64)size * stride);
+    if (!sg_snapshot_close(&reader, &header) || !loaded)
+    {
+        sg_vector_destroy(&vector);
+        return 0;
+    }
+
+    *p_vector = vector;
+    return 1;
+}
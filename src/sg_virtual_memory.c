@@ -0,0 +1,160 @@
+#include "sg_virtual_memory.h"
+#include "sg_assert.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+sg_u64 sg_virtual_memory_page_size(void)
+{
+    static sg_u64 s_page_size = 0;
+    if (s_page_size == 0)
+    {
+#if defined(_WIN32)
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        s_page_size = info.dwPageSize;
+#else
+        s_page_size = (sg_u64)sysconf(_SC_PAGESIZE);
+#endif
+    }
+
+    return s_page_size;
+}
+
+sg_u64 sg_virtual_memory_round_up(sg_u64 size)
+{
+    sg_u64 page_size = sg_virtual_memory_page_size();
+    return (size + page_size - 1) & ~(page_size - 1);
+}
+
+void* sg_virtual_memory_reserve(sg_u64 size)
+{
+#if defined(_WIN32)
+    return VirtualAlloc(NULL, (SIZE_T)size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+    void* p_address = mmap(NULL, (size_t)size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return p_address == MAP_FAILED ? NULL : p_address;
+#endif
+}
+
+sg_u8 sg_virtual_memory_commit(void* p_address, sg_u64 size)
+{
+#if defined(_WIN32)
+    return VirtualAlloc(p_address, (SIZE_T)size, MEM_COMMIT, PAGE_READWRITE) != NULL;
+#else
+    return mprotect(p_address, (size_t)size, PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+
+void sg_virtual_memory_decommit(void* p_address, sg_u64 size)
+{
+#if defined(_WIN32)
+    VirtualFree(p_address, (SIZE_T)size, MEM_DECOMMIT);
+#else
+    // Dropping the pages first keeps them from counting against the process once protected again
+    madvise(p_address, (size_t)size, MADV_DONTNEED);
+    mprotect(p_address, (size_t)size, PROT_NONE);
+#endif
+}
+
+void sg_virtual_memory_release(void* p_address, sg_u64 size)
+{
+#if defined(_WIN32)
+    VirtualFree(p_address, 0, MEM_RELEASE);
+#else
+    munmap(p_address, (size_t)size);
+#endif
+}
+
+void sg_virtual_memory_advise(void* p_address, sg_u64 size, sg_u32 advice)
+{
+#if defined(_WIN32)
+    // Windows takes the sequential and random hints when the file is opened
+    if (advice == SG_VIRTUAL_MEMORY_ADVICE_WILLNEED)
+    {
+        WIN32_MEMORY_RANGE_ENTRY range;
+        range.VirtualAddress = p_address;
+        range.NumberOfBytes = (SIZE_T)size;
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+#else
+    int hint = MADV_NORMAL;
+    if (advice == SG_VIRTUAL_MEMORY_ADVICE_SEQUENTIAL) hint = MADV_SEQUENTIAL;
+    else if (advice == SG_VIRTUAL_MEMORY_ADVICE_RANDOM) hint = MADV_RANDOM;
+    else if (advice == SG_VIRTUAL_MEMORY_ADVICE_WILLNEED) hint = MADV_WILLNEED;
+
+    madvise(p_address, (size_t)size, hint);
+#endif
+}
+
+void* sg_virtual_memory_map_file(const char* path, sg_u8 copy_on_write, sg_u32 advice, sg_u64* p_size)
+{
+    *p_size = 0;
+    void* p_address = NULL;
+
+#if defined(_WIN32)
+    DWORD flags = FILE_ATTRIBUTE_NORMAL;
+    if (advice == SG_VIRTUAL_MEMORY_ADVICE_SEQUENTIAL) flags = FILE_FLAG_SEQUENTIAL_SCAN;
+    else if (advice == SG_VIRTUAL_MEMORY_ADVICE_RANDOM) flags = FILE_FLAG_RANDOM_ACCESS;
+
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, flags, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return NULL;
+
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+    {
+        // The view keeps the mapping and the file alive once the handles are closed
+        HANDLE mapping = CreateFileMappingA(file, NULL, copy_on_write ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, NULL);
+        if (mapping)
+        {
+            p_address = MapViewOfFile(mapping, copy_on_write ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+
+        if (p_address)
+            *p_size = (sg_u64)size.QuadPart;
+    }
+
+    CloseHandle(file);
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0)
+    {
+        int protection = copy_on_write ? PROT_READ | PROT_WRITE : PROT_READ;
+        p_address = mmap(NULL, (size_t)info.st_size, protection, MAP_PRIVATE, fd, 0);
+        if (p_address == MAP_FAILED)
+            p_address = NULL;
+        else
+            *p_size = (sg_u64)info.st_size;
+    }
+
+    // The mapping holds its own reference to the file
+    close(fd);
+#endif
+
+    if (p_address && advice != SG_VIRTUAL_MEMORY_ADVICE_NORMAL)
+        sg_virtual_memory_advise(p_address, *p_size, advice);
+
+    return p_address;
+}
+
+void sg_virtual_memory_unmap_file(void* p_address, sg_u64 size)
+{
+#if defined(_WIN32)
+    UnmapViewOfFile(p_address);
+#else
+    munmap(p_address, (size_t)size);
+#endif
+}
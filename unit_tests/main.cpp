@@ -1,12 +1,30 @@
+#include <algorithm>
+#include <atomic>
 #include <functional>
+#include <random>
 #include <gtest/gtest.h>
 #include <stdio.h>
+#include <thread>
+#include <vector>
 
 extern "C" 
 {
+#include "sg_allocator.h"
+#include "sg_arena.h"
+#include "sg_cpu.h"
+#include "sg_parallel.h"
+#include "sg_pool_allocator.h"
+#include "sg_thread_cache_allocator.h"
+#include "sg_tracking_allocator.h"
+#include "sg_snapshot.h"
+#include "sg_stream.h"
 #include "sg_slice.h"
+#include "sg_soa_vector.h"
+#include "sg_sort.h"
 #include "sg_vector.h"
 #include "sg_hash_table.h"    
+#include "sg_concurrent_hash_table.h"
+#include "sg_atomic_hash_table.h"
 }
 
 #define VECTOR_SIZE 4096
@@ -32,6 +50,11 @@ struct edge
         }
     }
 
+    sg_u64 pair() const
+    {
+        return ((sg_u64)_i0 << 32) | (sg_u64)_i1;
+    }
+
     sg_u32 key()
     {
         sg_u64 k = ((sg_u64)_i0 << 32) | (sg_u64)_i1;
@@ -53,9 +76,30 @@ struct edge
 
 SG_SLICE_DEFINE_TYPE_EXT(custom_type_slice, custom_type)
 SG_VECTOR_DEFINE_TYPE_EXT(custom_type_vector, custom_type)
+SG_SOA_VECTOR_DEFINE_TYPE_EXT3(custom_type_soa_vector, sg_u32, hash, sg_f32, weight, custom_type, value)
 SG_HASH_TABLE_DEFINE_TYPE_EXT(edge_type_table, edge);
+SG_HASH_TABLE_DEFINE_KEY_TYPE_EXT(edge_pair_table, sg_u64, edge);
+
+struct tri_key
+{
+    sg_u32 _i[3];
+};
+
+static sg_u32 tri_key_hash(const void* p_key, sg_u32 /* key_stride */)
+{
+    const tri_key* p_tri = (const tri_key*)p_key;
+    return p_tri->_i[0] * 73856093U ^ p_tri->_i[1] * 19349663U ^ p_tri->_i[2] * 83492791U;
+}
+
+static sg_u8 tri_key_equal(const void* p_key_a, const void* p_key_b, sg_u32 /* key_stride */)
+{
+    const tri_key* p_a = (const tri_key*)p_key_a;
+    const tri_key* p_b = (const tri_key*)p_key_b;
+    return p_a->_i[0] == p_b->_i[0] && p_a->_i[1] == p_b->_i[1] && p_a->_i[2] == p_b->_i[2];
+}
 
 #define HASH_TABLE_LOAD_FACTOR 0.6f
+#define NUM_THREADS 4
 #define HASH_TABLE_SIZE 4096
 #define PLANE_ROWS 1024
 #define PLANE_COLS 1024
@@ -142,6 +186,128 @@ namespace sg
             delete[] p_arr;
         }
 
+        TEST(sg_cpu, dispatch)
+        {
+            sg_cpu_features features = sg_cpu_detect();
+            ASSERT_TRUE(features.level < SG_CPU_LEVEL_COUNT);
+            ASSERT_TRUE(sg_cpu_level() <= features.level);
+            ASSERT_TRUE(features.level < SG_CPU_LEVEL_AVX2 || features.avx2);
+
+            ASSERT_TRUE(sg_cpu_level_parse("avx2") == SG_CPU_LEVEL_AVX2);
+            ASSERT_TRUE(sg_cpu_level_parse("1") == SG_CPU_LEVEL_SSE2);
+            ASSERT_TRUE(sg_cpu_level_parse("bogus") == SG_CPU_LEVEL_NULL);
+            ASSERT_TRUE(sg_cpu_level_parse(sg_cpu_level_name(SG_CPU_LEVEL_AVX512)) == SG_CPU_LEVEL_AVX512);
+
+            // Requests past the detected level are clamped
+            sg_u32 restore = sg_cpu_level();
+            ASSERT_TRUE(sg_cpu_set_level(SG_CPU_LEVEL_AVX512) == features.level);
+            ASSERT_TRUE(sg_cpu_dispatch_table()->level == features.level);
+
+            // Past the streaming threshold at an odd address and size, the neighbours stay untouched
+            const sg_u64 size = SG_CPU_STREAM_THRESHOLD * 2 + 13;
+            std::vector<sg_u8> bytes(size + 2);
+            for (sg_u32 level = SG_CPU_LEVEL_SCALAR; level <= features.level; ++level)
+            {
+                ASSERT_TRUE(sg_cpu_set_level(level) == level);
+                std::fill(bytes.begin(), bytes.end(), (sg_u8)0xAB);
+                sg_cpu_memclear(bytes.data() + 1, size);
+
+                ASSERT_TRUE(bytes.front() == 0xAB && bytes.back() == 0xAB);
+                ASSERT_TRUE(std::all_of(bytes.begin() + 1, bytes.end() - 1, [](sg_u8 byte) { return byte == 0; }));
+            }
+
+            sg_cpu_set_level(restore);
+        }
+
+        TEST(sg_slice, kernels)
+        {
+            std::mt19937 rng(5);
+            std::vector<sg_u8> bytes(4096 * 8 + 5);
+            std::vector<sg_u8> other(bytes.size());
+            for (sg_u8& byte : bytes)
+                byte = (sg_u8)(rng() % 7);
+
+            sg_u32 supported = sg_cpu_detect().level;
+            sg_u32 widths[] = { 1, 2, 4, 8 };
+            for (sg_u32 level = SG_CPU_LEVEL_SCALAR; level <= supported; ++level)
+            {
+                ASSERT_TRUE(sg_cpu_set_level(level) == level);
+                for (sg_u32 width : widths)
+                {
+                    // Odd counts leave a tail for the scalar loop
+                    sg_u32 count = (sg_u32)bytes.size() / width - 1;
+                    sg_slice slice = sg_slice_make(bytes.data(), 0, count, width);
+
+                    sg_u64 values[] = { 0, 1, 6, 7, 0x0101, 0x0000000600000000ull, ~0ull };
+                    for (sg_u64 value : values)
+                    {
+                        sg_u32 first = SG_SLICE_IDX_NULL;
+                        sg_u32 matches = 0;
+                        for (sg_u32 i = 0; i < count; ++i)
+                        {
+                            sg_u64 element = 0;
+                            memcpy(&element, sg_slice_data(&slice, i), width);
+                            if (element == value)
+                            {
+                                first = std::min(first, i);
+                                matches += 1;
+                            }
+                        }
+
+                        ASSERT_TRUE(sg_slice_find(&slice, value) == first);
+                        ASSERT_TRUE(sg_slice_count(&slice, value) == matches);
+                    }
+
+                    sg_u64 expected_min = ~0ull;
+                    sg_u64 expected_max = 0;
+                    for (sg_u32 i = 0; i < count; ++i)
+                    {
+                        sg_u64 element = 0;
+                        memcpy(&element, sg_slice_data(&slice, i), width);
+                        expected_min = std::min(expected_min, element);
+                        expected_max = std::max(expected_max, element);
+                    }
+
+                    sg_u64 min = 0, max = 0;
+                    ASSERT_TRUE(sg_slice_min_max(&slice, &min, &max));
+                    ASSERT_TRUE(min == expected_min && max == expected_max);
+
+                    // A single value at the end of the scan
+                    sg_slice last = sg_slice_to_slice(&slice, count - 1, 1);
+                    sg_slice other_slice = sg_slice_make(other.data(), 0, count, width);
+                    sg_slice_fill(&other_slice, sg_slice_data(&last, 0));
+                    for (sg_u32 i = 0; i < count; ++i)
+                        ASSERT_TRUE(memcmp(sg_slice_data(&other_slice, i), sg_slice_data(&last, 0), width) == 0);
+
+                    memcpy(other.data(), bytes.data(), bytes.size());
+                    ASSERT_TRUE(sg_slice_equal(&slice, &other_slice));
+                    other[count * width - 1] ^= 1;
+                    ASSERT_FALSE(sg_slice_equal(&slice, &other_slice));
+                }
+
+                // Fields out of 12 and 24 byte elements
+                struct element { sg_u32 a; sg_u64 b; sg_u32 c; sg_u32 d; };
+                std::vector<element> elements(1000);
+                for (sg_u32 i = 0; i < elements.size(); ++i)
+                    elements[i] = { i, (sg_u64)i << 33, i * 3, i * 5 };
+
+                sg_slice element_slice = sg_slice_make(elements.data(), 0, (sg_u32)elements.size(), sizeof(element));
+                std::vector<sg_u32> cs(elements.size());
+                std::vector<sg_u64> bs(elements.size());
+                sg_slice_gather(&element_slice, offsetof(element, c), sizeof(sg_u32), cs.data());
+                sg_slice_gather(&element_slice, offsetof(element, b), sizeof(sg_u64), bs.data());
+                for (sg_u32 i = 0; i < elements.size(); ++i)
+                    ASSERT_TRUE(cs[i] == i * 3 && bs[i] == (sg_u64)i << 33);
+
+                element fill = { 1, 2, 3, 4 };
+                sg_slice_fill(&element_slice, &fill);
+                for (const element& e : elements)
+                    ASSERT_TRUE(e.a == 1 && e.b == 2 && e.c == 3 && e.d == 4);
+            }
+
+            sg_cpu_set_level(supported);
+        }
+
         TEST(sg_vector, create)
         {
             sg_vector vector = sg_vector_create(VECTOR_SIZE, sizeof(uint32_t), 0);
@@ -211,6 +377,66 @@ namespace sg
             sg_vector_destroy(&vector);
         }
 
+        TEST(sg_vector, growth)
+        {
+            sg_vector vector = sg_vector_create(0, sizeof(uint32_t), 0);
+            sg_vector_set_growth(&vector, SG_VECTOR_GROWTH_INCREMENT, 100.0f);
+            for (sg_u32 i = 0; i < VECTOR_SIZE; ++i)
+            {
+                sg_vector_push(&vector, &i);
+                ASSERT_TRUE(vector._capacity % 100 == 0);
+            }
+
+            sg_vector_destroy(&vector);
+
+            vector = sg_vector_create(0, sizeof(uint32_t), 0);
+            sg_vector_set_growth(&vector, SG_VECTOR_GROWTH_PAGE, 1.5f);
+            for (sg_u32 i = 0; i < VECTOR_SIZE; ++i)
+            {
+                sg_vector_push(&vector, &i);
+                ASSERT_TRUE(vector._buffer.size % sg_virtual_memory_page_size() == 0);
+            }
+
+            for (sg_u32 i = 0; i < VECTOR_SIZE; ++i)
+                ASSERT_TRUE(*(sg_u32*)sg_vector_data(&vector, i) == i);
+
+            sg_vector_destroy(&vector);
+        }
+
+        TEST(sg_vector, shrink_to_fit)
+        {
+            sg_vector vector = sg_vector_create(0, sizeof(uint32_t), 0);
+            for (sg_u32 i = 0; i < VECTOR_SIZE + 1; ++i)
+                sg_vector_push(&vector, &i);
+
+            ASSERT_TRUE(vector._capacity > VECTOR_SIZE + 1);
+            sg_vector_shrink_to_fit(&vector);
+            ASSERT_TRUE(vector._capacity == VECTOR_SIZE + 1);
+            ASSERT_TRUE(vector._buffer.size == vector._capacity * vector._stride);
+            for (sg_u32 i = 0; i < VECTOR_SIZE + 1; ++i)
+                ASSERT_TRUE(*(sg_u32*)sg_vector_data(&vector, i) == i);
+
+            sg_vector_clear_and_release(&vector);
+            ASSERT_TRUE(vector._buffer.allocation == 0);
+            ASSERT_TRUE(vector._capacity == 0);
+            ASSERT_TRUE(vector._size == 0);
+
+            // Still usable after giving everything back
+            sg_u32 value = 7;
+            sg_vector_push(&vector, &value);
+            ASSERT_TRUE(*(sg_u32*)sg_vector_back(&vector) == 7);
+            sg_vector_destroy(&vector);
+
+            // Reserved vectors decommit down to the page holding the last element
+            vector = sg_vector_create_reserved(VECTOR_SIZE * 16, sizeof(sg_u32), VECTOR_SIZE * 16);
+            sg_u8* p_data = vector._buffer.allocation;
+            sg_vector_resize(&vector, 1);
+            sg_vector_shrink_to_fit(&vector);
+            ASSERT_TRUE(vector._buffer.allocation == p_data);
+            ASSERT_TRUE(vector._buffer.size == sg_virtual_memory_page_size());
+            sg_vector_destroy(&vector);
+        }
+
         TEST(sg_vector, emplace)
         {
             sg_vector vector = sg_vector_create(0, sizeof(uint32_t), 0);
@@ -238,6 +464,71 @@ namespace sg
             sg_vector_destroy(&vector);
         }
 
+        TEST(sg_vector, append_insert_range)
+        {
+            std::vector<sg_u32> expected(VECTOR_SIZE);
+            for (sg_u32 i = 0; i < VECTOR_SIZE; ++i)
+                expected[i] = i;
+
+            sg_vector vector = sg_vector_create(0, sizeof(sg_u32), 0);
+            sg_slice slice = sg_slice_make(expected.data(), 0, VECTOR_SIZE, sizeof(sg_u32));
+            ASSERT_TRUE(sg_vector_append(&vector, &slice) == 0);
+
+            // Appending the vector to itself survives the reallocation
+            slice = sg_vector_to_slice(&vector, 0, VECTOR_SIZE);
+            ASSERT_TRUE(sg_vector_append(&vector, &slice) == VECTOR_SIZE);
+            expected.insert(expected.end(), expected.begin(), expected.end());
+
+            sg_u32 values[] = { 100000, 100001, 100002 };
+            slice = sg_slice_make(values, 0, 3, sizeof(sg_u32));
+            sg_vector_insert_range(&vector, 10, &slice);
+            expected.insert(expected.begin() + 10, values, values + 3);
+            sg_vector_insert_range(&vector, sg_vector_size(&vector), &slice);
+            expected.insert(expected.end(), values, values + 3);
+
+            ASSERT_TRUE(sg_vector_size(&vector) == expected.size());
+            for (sg_u32 i = 0; i < sg_vector_size(&vector); ++i)
+                ASSERT_TRUE(*(sg_u32*)sg_vector_data(&vector, i) == expected[i]);
+
+            sg_vector_destroy(&vector);
+        }
+
+        TEST(sg_vector, erase_range_swap)
+        {
+            std::vector<sg_u32> expected(VECTOR_SIZE);
+            sg_vector vector = sg_vector_create(0, sizeof(sg_u32), 0);
+            for (sg_u32 i = 0; i < VECTOR_SIZE; ++i)
+            {
+                expected[i] = i;
+                sg_vector_push(&vector, &i);
+            }
+
+            sg_vector_erase_range(&vector, 0, 100);
+            expected.erase(expected.begin(), expected.begin() + 100);
+            sg_vector_erase_range(&vector, 50, 25);
+            expected.erase(expected.begin() + 50, expected.begin() + 75);
+            sg_vector_erase_range(&vector, sg_vector_size(&vector) - 10, 10);
+            expected.erase(expected.end() - 10, expected.end());
+            sg_vector_erase(&vector, 3);
+            expected.erase(expected.begin() + 3);
+
+            ASSERT_TRUE(sg_vector_size(&vector) == expected.size());
+            for (sg_u32 i = 0; i < sg_vector_size(&vector); ++i)
+                ASSERT_TRUE(*(sg_u32*)sg_vector_data(&vector, i) == expected[i]);
+
+            sg_vector_erase_swap(&vector, 0);
+            expected[0] = expected.back();
+            expected.pop_back();
+            sg_vector_erase_swap(&vector, sg_vector_size(&vector) - 1);
+            expected.pop_back();
+
+            ASSERT_TRUE(sg_vector_size(&vector) == expected.size());
+            for (sg_u32 i = 0; i < sg_vector_size(&vector); ++i)
+                ASSERT_TRUE(*(sg_u32*)sg_vector_data(&vector, i) == expected[i]);
+
+            sg_vector_destroy(&vector);
+        }
+
         TEST(sg_vector, type_ext)
         {
             custom_type_vector vector = custom_type_vector_create(0, 0);
@@ -268,6 +559,225 @@ namespace sg
             custom_type_vector_destroy(&vector);
         }
 
+        TEST(sg_soa_vector, type_ext)
+        {
+            custom_type_soa_vector vector = custom_type_soa_vector_create(0, 0);
+            for (sg_u32 i = 0; i < VECTOR_SIZE; ++i)
+            {
+                custom_type value;
+                snprintf(value.sz_message, custom_type::MAX_MSG, "%u", i);
+                value.hash = i;
+                ASSERT_TRUE(custom_type_soa_vector_push(&vector, i, (sg_f32)i * 0.5f, value) == i);
+            }
+
+            ASSERT_TRUE(custom_type_soa_vector_size(&vector) == VECTOR_SIZE);
+
+            // Each column is contiguous and starts on a cache line
+            sg_slice hashes = custom_type_soa_vector_hash_column(&vector);
+            sg_slice weights = custom_type_soa_vector_weight_column(&vector);
+            ASSERT_TRUE(hashes._stride == sizeof(sg_u32) && hashes._count == VECTOR_SIZE);
+            ASSERT_TRUE(((uintptr_t)hashes._data % SG_SOA_VECTOR_COLUMN_ALIGNMENT) == 0);
+            ASSERT_TRUE(((uintptr_t)weights._data % SG_SOA_VECTOR_COLUMN_ALIGNMENT) == 0);
+            for (sg_u32 i = 0; i < VECTOR_SIZE; ++i)
+            {
+                ASSERT_TRUE(((sg_u32*)hashes._data)[i] == i);
+                ASSERT_TRUE(((sg_f32*)weights._data)[i] == (sg_f32)i * 0.5f);
+                ASSERT_TRUE((sg_u32)atoi(custom_type_soa_vector_value(&vector, i)->sz_message) == i);
+            }
+
+            // Erasing moves every column together
+            custom_type_soa_vector_erase_swap(&vector, 0);
+            ASSERT_TRUE(*custom_type_soa_vector_hash(&vector, 0) == VECTOR_SIZE - 1);
+            ASSERT_TRUE((sg_u32)atoi(custom_type_soa_vector_value(&vector, 0)->sz_message) == VECTOR_SIZE - 1);
+
+            custom_type_soa_vector_erase(&vector, 0);
+            ASSERT_TRUE(custom_type_soa_vector_size(&vector) == VECTOR_SIZE - 2);
+            for (sg_u32 i = 0; i < custom_type_soa_vector_size(&vector); ++i)
+            {
+                ASSERT_TRUE(*custom_type_soa_vector_hash(&vector, i) == i + 1);
+                ASSERT_TRUE(custom_type_soa_vector_value(&vector, i)->hash == i + 1);
+            }
+
+            sg_u32 index = custom_type_soa_vector_emplace(&vector);
+            ASSERT_TRUE(*custom_type_soa_vector_hash(&vector, index) == 0);
+            ASSERT_TRUE(*custom_type_soa_vector_weight(&vector, index) == 0.0f);
+
+            custom_type_soa_vector_destroy(&vector);
+            ASSERT_TRUE(vector._allocation == NULL);
+            ASSERT_TRUE(vector._size == 0);
+        }
+
+        TEST(sg_soa_vector, grow_failure)
+        {
+            // Allocations fail while the flag behind p_user_data is set, aligned blocks go through allocate
+            bool fail = false;
+            sg_allocator failing = s_allocator_default;
+            failing.p_user_data = &fail;
+            failing.allocate = [](sg_u64 size, void* p_user_data) -> void* { return *(bool*)p_user_data ? NULL : malloc(size); };
+            failing.free = [](void* p_allocation, void*) { free(p_allocation); };
+            failing.allocate_aligned = NULL;
+            failing.free_aligned = NULL;
+            failing.realloc_aligned = NULL;
+
+            custom_type_soa_vector vector = custom_type_soa_vector_create(0, &failing);
+            custom_type value = {};
+            sg_u32 i = 0;
+            while (vector._size < vector._capacity || vector._capacity == 0)
+            {
+                ASSERT_TRUE(custom_type_soa_vector_push(&vector, i, (sg_f32)i, value) == i);
+                i += 1;
+            }
+
+            // A full vector that can not grow keeps its elements
+            fail = true;
+            sg_u32 capacity = vector._capacity;
+            ASSERT_TRUE(custom_type_soa_vector_push(&vector, i, (sg_f32)i, value) == SG_SOA_VECTOR_IDX_NULL);
+            ASSERT_TRUE(custom_type_soa_vector_emplace(&vector) == SG_SOA_VECTOR_IDX_NULL);
+            ASSERT_FALSE(custom_type_soa_vector_reserve(&vector, capacity + 1));
+            ASSERT_FALSE(custom_type_soa_vector_resize(&vector, capacity + 1));
+            ASSERT_TRUE(custom_type_soa_vector_size(&vector) == i);
+            ASSERT_TRUE(vector._capacity == capacity);
+            for (sg_u32 j = 0; j < i; ++j)
+                ASSERT_TRUE(*custom_type_soa_vector_hash(&vector, j) == j);
+
+            fail = false;
+            ASSERT_TRUE(custom_type_soa_vector_resize(&vector, capacity + 1));
+            ASSERT_TRUE(custom_type_soa_vector_push(&vector, i + 1, (sg_f32)i, value) == i + 1);
+
+            // The last index is the sentinel, a vector of that size can not grow
+            vector._size = SG_SOA_VECTOR_IDX_NULL;
+            ASSERT_TRUE(custom_type_soa_vector_emplace(&vector) == SG_SOA_VECTOR_IDX_NULL);
+            vector._size = i + 2;
+
+            custom_type_soa_vector_destroy(&vector);
+        }
+
+        TEST(sg_vector, create_aligned)
+        {
+            sg_arena arena = sg_arena_create(0, NULL);
+            sg_pool_allocator pool = sg_pool_allocator_create(0, NULL);
+            sg_allocator arena_allocator = sg_arena_allocator(&arena);
+            sg_allocator pool_allocator = sg_pool_allocator_allocator(&pool);
+
+            // Default, native and fallback aligned paths
+            sg_allocator* allocators[] = { NULL, &arena_allocator, &pool_allocator };
+            for (sg_allocator* p_allocator : allocators)
+            {
+                for (sg_u64 alignment = 16; alignment <= 128; alignment *= 2)
+                {
+                    sg_vector vector = sg_vector_create_aligned(3, sizeof(sg_u32), alignment, p_allocator);
+                    ASSERT_TRUE(((uintptr_t)vector._buffer.allocation % alignment) == 0);
+                    ASSERT_TRUE(*(sg_u32*)sg_vector_data(&vector, 2) == 0);
+
+                    for (sg_u32 i = 0; i < VECTOR_SIZE; ++i)
+                    {
+                        sg_vector_push(&vector, &i);
+                        ASSERT_TRUE(((uintptr_t)vector._buffer.allocation % alignment) == 0);
+                    }
+
+                    for (sg_u32 i = 0; i < VECTOR_SIZE; ++i)
+                        ASSERT_TRUE(*(sg_u32*)sg_vector_data(&vector, i + 3) == i);
+
+                    sg_vector_destroy(&vector);
+                }
+            }
+
+            sg_pool_allocator_destroy(&pool);
+            sg_arena_destroy(&arena);
+        }
+
+        TEST(sg_vector, create_reserved)
+        {
+            const sg_u32 max_size = 1024 * 1024;
+
+            sg_vector vector = sg_vector_create_reserved(16, sizeof(sg_u32), max_size);
+            ASSERT_TRUE(vector._buffer.reserved >= (sg_u64)max_size * sizeof(sg_u32));
+            ASSERT_TRUE(vector._capacity >= 16);
+            ASSERT_TRUE(*(sg_u32*)sg_vector_data(&vector, 15) == 0);
+
+            // Growth commits pages in place so the data never moves
+            sg_u8* p_data = vector._buffer.allocation;
+            sg_u32* p_first = (sg_u32*)sg_vector_data(&vector, 0);
+            *p_first = 7;
+
+            for (sg_u32 i = 16; i < max_size; ++i)
+                sg_vector_push(&vector, &i);
+
+            ASSERT_TRUE(vector._buffer.allocation == p_data);
+            ASSERT_TRUE(*p_first == 7);
+            ASSERT_TRUE(vector._capacity == max_size);
+            for (sg_u32 i = 16; i < max_size; ++i)
+                ASSERT_TRUE(*(sg_u32*)sg_vector_data(&vector, i) == i);
+
+            sg_vector_destroy(&vector);
+            ASSERT_TRUE(vector._buffer.allocation == NULL);
+            ASSERT_TRUE(vector._buffer.reserved == 0);
+
+            // Growth stops at max_size even inside the last committed page
+            const sg_u32 small_size = 1000;
+            vector = sg_vector_create_reserved(0, sizeof(sg_u32), small_size);
+            for (sg_u32 i = 0; i < small_size; ++i)
+                ASSERT_TRUE(sg_vector_push(&vector, &i) == i);
+
+            sg_u32 value = 0;
+            ASSERT_TRUE(sg_vector_push(&vector, &value) == SG_VECTOR_IDX_NULL);
+            ASSERT_TRUE(sg_vector_emplace(&vector) == NULL);
+            ASSERT_FALSE(sg_vector_reserve(&vector, small_size + 1));
+            ASSERT_FALSE(sg_vector_resize(&vector, small_size + 1));
+            ASSERT_TRUE(sg_vector_size(&vector) == small_size && vector._capacity == small_size);
+
+            sg_slice slice = sg_vector_to_slice(&vector, 0, 1);
+            ASSERT_TRUE(sg_vector_append(&vector, &slice) == SG_VECTOR_IDX_NULL);
+            ASSERT_TRUE(sg_vector_resize(&vector, small_size / 2));
+            ASSERT_TRUE(*(sg_u32*)sg_vector_back(&vector) == small_size / 2 - 1);
+            sg_vector_destroy(&vector);
+        }
+
+        TEST(sg_vector, create_mapped)
+        {
+            const char* path = "sg_vector_create_mapped.bin";
+
+            FILE* p_file = fopen(path, "wb");
+            ASSERT_TRUE(p_file != NULL);
+            for (sg_u32 i = 0; i < VECTOR_SIZE; ++i)
+                fwrite(&i, sizeof(sg_u32), 1, p_file);
+            fclose(p_file);
+
+            sg_vector vector = sg_vector_create_mapped(path, sizeof(sg_u32), 0, SG_VIRTUAL_MEMORY_ADVICE_SEQUENTIAL);
+            ASSERT_TRUE(vector._buffer.mapped);
+            ASSERT_TRUE(sg_vector_size(&vector) == VECTOR_SIZE);
+            for (sg_u32 i = 0; i < VECTOR_SIZE; ++i)
+                ASSERT_TRUE(*(sg_u32*)sg_vector_data(&vector, i) == i);
+
+            sg_slice slice = sg_vector_to_slice(&vector, VECTOR_SIZE / 2, VECTOR_SIZE / 2);
+            ASSERT_TRUE(*(sg_u32*)sg_slice_data(&slice, 0) == VECTOR_SIZE / 2);
+
+            // The mapping can not grow
+            sg_u32 value = 0;
+            ASSERT_TRUE(sg_vector_push(&vector, &value) == SG_VECTOR_IDX_NULL);
+            ASSERT_TRUE(sg_vector_emplace(&vector) == NULL);
+            ASSERT_FALSE(sg_vector_reserve(&vector, VECTOR_SIZE + 1));
+            ASSERT_TRUE(sg_vector_size(&vector) == VECTOR_SIZE);
+            sg_vector_destroy(&vector);
+
+            // Copy on write pages take writes without reaching the file
+            sg_vector copy = sg_vector_create_mapped(path, sizeof(sg_u32), 1, SG_VIRTUAL_MEMORY_ADVICE_RANDOM);
+            ASSERT_TRUE(sg_vector_size(&copy) == VECTOR_SIZE);
+            *(sg_u32*)sg_vector_data(&copy, 0) = 1234;
+            ASSERT_TRUE(*(sg_u32*)sg_vector_data(&copy, 0) == 1234);
+            sg_vector_destroy(&copy);
+
+            vector = sg_vector_create_mapped(path, sizeof(sg_u32), 0, SG_VIRTUAL_MEMORY_ADVICE_NORMAL);
+            ASSERT_TRUE(*(sg_u32*)sg_vector_data(&vector, 0) == 0);
+            sg_vector_destroy(&vector);
+            remove(path);
+
+            vector = sg_vector_create_mapped(path, sizeof(sg_u32), 0, SG_VIRTUAL_MEMORY_ADVICE_NORMAL);
+            ASSERT_TRUE(vector._buffer.allocation == NULL);
+            ASSERT_TRUE(sg_vector_size(&vector) == 0);
+            sg_vector_destroy(&vector);
+        }
+
         TEST(sg_hash_table, create)
         {
             sg_hash_table table = sg_hash_table_create(HASH_TABLE_SIZE, sizeof(uint32_t), HASH_TABLE_LOAD_FACTOR, NULL);
@@ -370,6 +880,188 @@ namespace sg
             sg_hash_table_destroy(&table);
         }
 
+        TEST(sg_hash_table, find_miss)
+        {
+            sg_hash_table table = sg_hash_table_create(0, sizeof(uint32_t), 0.9f, NULL);
+
+            for (sg_u32 i = 0; i < HASH_TABLE_SIZE; ++i)
+            {
+                sg_u32 key = i * 7919U;
+                sg_hash_table_insert(&table, key, &i);
+            }
+
+            for (sg_u32 i = 0; i < HASH_TABLE_SIZE; ++i)
+            {
+                sg_u32* p = NULL;
+                bool found = sg_hash_table_find_value(&table, i * 7919U, (void**)&p);
+                ASSERT_TRUE(found);
+                ASSERT_TRUE(i == *p);
+
+                ASSERT_FALSE(sg_hash_table_find(&table, i * 7919U + 1U));
+            }
+
+            sg_hash_table_destroy(&table);
+        }
+
+        TEST(sg_hash_table, high_load)
+        {
+            sg_hash_table table = sg_hash_table_create(0, sizeof(uint32_t), 0.95f, NULL);
+
+            sg_u32 key = 1;
+            for (sg_u32 i = 0; i < HASH_TABLE_SIZE * 4; ++i)
+            {
+                key = key * 1664525U + 1013904223U;
+                sg_hash_table_insert(&table, key, &i);
+            }
+
+            ASSERT_TRUE(sg_hash_table_size(&table) == HASH_TABLE_SIZE * 4);
+
+            key = 1;
+            for (sg_u32 i = 0; i < HASH_TABLE_SIZE * 4; ++i)
+            {
+                key = key * 1664525U + 1013904223U;
+
+                sg_u32* p = NULL;
+                bool found = sg_hash_table_find_value(&table, key, (void**)&p);
+                ASSERT_TRUE(found);
+                ASSERT_TRUE(i == *p);
+            }
+
+            for (sg_u32 i = 0; i < HASH_TABLE_SIZE * 4; ++i)
+            {
+                key = key * 1664525U + 1013904223U;
+                ASSERT_FALSE(sg_hash_table_find(&table, key));
+            }
+
+            sg_hash_table_destroy(&table);
+        }
+
+        TEST(sg_hash_table, remove_reinsert)
+        {
+            sg_hash_table table = sg_hash_table_create(0, sizeof(uint32_t), 0.9f, NULL);
+
+            for (sg_u32 i = 0; i < HASH_TABLE_SIZE; ++i)
+            {
+                sg_hash_table_insert(&table, i, &i);
+            }
+
+            for (sg_u32 pass = 0; pass < 4; ++pass)
+            {
+                for (sg_u32 i = pass; i < HASH_TABLE_SIZE; i += 4)
+                {
+                    sg_hash_table_remove(&table, i);
+                    ASSERT_FALSE(sg_hash_table_find(&table, i));
+                }
+
+                ASSERT_TRUE(sg_hash_table_size(&table) == HASH_TABLE_SIZE - HASH_TABLE_SIZE / 4);
+
+                for (sg_u32 i = 0; i < HASH_TABLE_SIZE; ++i)
+                {
+                    sg_u32* p = NULL;
+                    bool found = sg_hash_table_find_value(&table, i, (void**)&p);
+                    if (i % 4 == pass)
+                    {
+                        ASSERT_FALSE(found);
+                    }
+                    else
+                    {
+                        ASSERT_TRUE(found);
+                        ASSERT_TRUE(i == *p);
+                    }
+                }
+
+                for (sg_u32 i = pass; i < HASH_TABLE_SIZE; i += 4)
+                {
+                    sg_hash_table_insert(&table, i, &i);
+                }
+            }
+
+            ASSERT_TRUE(sg_hash_table_size(&table) == HASH_TABLE_SIZE);
+
+            sg_hash_table_destroy(&table);
+        }
+
+        TEST(sg_hash_table, incremental)
+        {
+            sg_hash_table table = sg_hash_table_create(0, sizeof(uint32_t), 0.6f, NULL);
+            sg_hash_table_set_incremental(&table, 2);
+
+            sg_u32 migrating = 0;
+            for (sg_u32 i = 0; i < HASH_TABLE_SIZE * 4; ++i)
+            {
+                sg_hash_table_insert(&table, i, &i);
+                if (table._prev_ctrl != NULL)
+                    migrating += 1;
+
+                // Removing a third of the keys while buckets are split across both arrays
+                if (i % 3 == 0)
+                    sg_hash_table_remove(&table, i / 3);
+            }
+
+            ASSERT_TRUE(migrating != 0);
+
+            sg_u32 num_removed = (HASH_TABLE_SIZE * 4 - 1) / 3 + 1;
+            for (sg_u32 i = 0; i < HASH_TABLE_SIZE * 4; ++i)
+            {
+                sg_u32* p = NULL;
+                bool found = sg_hash_table_find_value(&table, i, (void**)&p);
+                if (i < num_removed)
+                {
+                    ASSERT_FALSE(found);
+                }
+                else
+                {
+                    ASSERT_TRUE(found);
+                    ASSERT_TRUE(i == *p);
+                }
+            }
+
+            while (sg_hash_table_migrate(&table, 16)) {}
+
+            ASSERT_TRUE(table._prev_ctrl == NULL);
+            ASSERT_TRUE(sg_hash_table_size(&table) == HASH_TABLE_SIZE * 4 - num_removed);
+
+            sg_hash_table_destroy(&table);
+        }
+
+        TEST(sg_hash_table, batch)
+        {
+            sg_u32* vtx_idx_data = create_idx_buf_plane(PLANE_ROWS / 4, PLANE_COLS / 4);
+            sg_u32 num_idx = (PLANE_ROWS / 4) * (PLANE_COLS / 4) * 6;
+
+            // Keys are the index buffer positions scrambled, values the vertex they reference
+            sg_u32* p_keys = new sg_u32[num_idx * 2];
+            for (sg_u32 i = 0; i < num_idx * 2; ++i)
+                p_keys[i] = i * 2654435761U;
+
+            sg_hash_table table = sg_hash_table_create(0, sizeof(uint32_t), 0.6f, NULL);
+            sg_hash_table_insert_batch(&table, p_keys, vtx_idx_data, num_idx);
+
+            ASSERT_TRUE(sg_hash_table_size(&table) == num_idx);
+
+            void** pp_values = new void*[num_idx * 2];
+            sg_u32 found = sg_hash_table_find_batch(&table, p_keys, num_idx * 2, pp_values);
+            ASSERT_TRUE(found == num_idx);
+
+            for (sg_u32 i = 0; i < num_idx * 2; ++i)
+            {
+                if (i < num_idx)
+                {
+                    ASSERT_TRUE(pp_values[i] != NULL);
+                    ASSERT_TRUE(*(sg_u32*)pp_values[i] == vtx_idx_data[i]);
+                }
+                else
+                {
+                    ASSERT_TRUE(pp_values[i] == NULL);
+                }
+            }
+
+            delete[] pp_values;
+            delete[] p_keys;
+            sg_hash_table_destroy(&table);
+            destroy_idx_buf_plane(vtx_idx_data);
+        }
+
         TEST(sg_hash_table, type_ext)
         {
             sg_u32* vtx_idx_data = create_idx_buf_plane(PLANE_ROWS, PLANE_COLS);
@@ -424,5 +1116,975 @@ namespace sg
             edge_type_table_destroy(&table);
             destroy_idx_buf_plane(vtx_idx_data);
         }
-    }
-}
+
+        TEST(sg_hash_table, key_type_ext)
+        {
+            sg_u32* vtx_idx_data = create_idx_buf_plane(PLANE_ROWS / 4, PLANE_COLS / 4);
+            edge_pair_table table = edge_pair_table_create(0, 0.6f, NULL);
+
+            ASSERT_TRUE(table._key_stride == sizeof(sg_u64));
+
+            sg_u32 num_tri = (PLANE_ROWS / 4) * (PLANE_COLS / 4) * 2;
+            for (sg_u32 tri_idx = 0; tri_idx < num_tri; ++tri_idx)
+            {
+                sg_u32 i0 = vtx_idx_data[tri_idx * 3 + 0];
+                sg_u32 i1 = vtx_idx_data[tri_idx * 3 + 1];
+                sg_u32 i2 = vtx_idx_data[tri_idx * 3 + 2];
+
+                edge edges[3] = { { i0, i1 }, { i0, i2 }, { i1, i2 } };
+                for (sg_u32 e = 0; e < 3; ++e)
+                {
+                    if (!edge_pair_table_find(&table, edges[e].pair())) edge_pair_table_insert(&table, edges[e].pair(), edges[e]);
+                }
+            }
+
+            // Interior edges are shared by two triangles, boundary edges by one
+            sg_u32 rows = PLANE_ROWS / 4;
+            sg_u32 cols = PLANE_COLS / 4;
+            ASSERT_TRUE(sg_hash_table_size(&table) == rows * (cols + 1) + cols * (rows + 1) + rows * cols);
+
+            for (sg_u32 tri_idx = 0; tri_idx < num_tri; ++tri_idx)
+            {
+                sg_u32 i0 = vtx_idx_data[tri_idx * 3 + 0];
+                sg_u32 i1 = vtx_idx_data[tri_idx * 3 + 1];
+
+                edge e0 = { i0, i1 };
+                edge* p0 = nullptr;
+                ASSERT_TRUE(edge_pair_table_find_value(&table, e0.pair(), &p0));
+                ASSERT_TRUE(p0->_i0 == e0._i0 && p0->_i1 == e0._i1);
+            }
+
+            ASSERT_FALSE(edge_pair_table_find(&table, ~0ull));
+
+            edge_pair_table_destroy(&table);
+            destroy_idx_buf_plane(vtx_idx_data);
+        }
+
+        TEST(sg_hash_table, key_bytes)
+        {
+            sg_hash_table tables[2] =
+            {
+                sg_hash_table_create_ext(0, sizeof(tri_key), sizeof(sg_u32), 0.6f, NULL, NULL, NULL),
+                sg_hash_table_create_ext(0, sizeof(tri_key), sizeof(sg_u32), 0.6f, &tri_key_hash, &tri_key_equal, NULL),
+            };
+
+            for (sg_hash_table& table : tables)
+            {
+                for (sg_u32 i = 0; i < HASH_TABLE_SIZE; ++i)
+                {
+                    tri_key key = { { i, i + 1, i + 2 } };
+                    sg_hash_table_insert_key(&table, &key, &i);
+                }
+
+                for (sg_u32 i = 0; i < HASH_TABLE_SIZE; ++i)
+                {
+                    tri_key key = { { i, i + 1, i + 2 } };
+                    sg_u32* p = NULL;
+                    ASSERT_TRUE(sg_hash_table_find_key_value(&table, &key, (void**)&p));
+                    ASSERT_TRUE(i == *p);
+
+                    tri_key miss = { { i, i + 2, i + 1 } };
+                    ASSERT_FALSE(sg_hash_table_find_key(&table, &miss));
+                }
+
+                for (sg_u32 i = 0; i < HASH_TABLE_SIZE; i += 2)
+                {
+                    tri_key key = { { i, i + 1, i + 2 } };
+                    sg_hash_table_remove_key(&table, &key);
+                }
+
+                ASSERT_TRUE(sg_hash_table_size(&table) == HASH_TABLE_SIZE / 2);
+
+                for (sg_u32 i = 0; i < HASH_TABLE_SIZE; ++i)
+                {
+                    tri_key key = { { i, i + 1, i + 2 } };
+                    ASSERT_TRUE(sg_hash_table_find_key(&table, &key) == (i % 2));
+                }
+
+                sg_hash_table_destroy(&table);
+            }
+        }
+
+        TEST(sg_concurrent_hash_table, insert_find)
+        {
+            sg_u32* vtx_idx_data = create_idx_buf_plane(PLANE_ROWS / 4, PLANE_COLS / 4);
+            sg_u32 rows = PLANE_ROWS / 4;
+            sg_u32 cols = PLANE_COLS / 4;
+            sg_u32 num_tri = rows * cols * 2;
+
+            sg_concurrent_hash_table table = sg_concurrent_hash_table_create_ext(16, 0, sizeof(sg_u64), sizeof(edge), 0.6f, NULL, NULL, NULL);
+            ASSERT_TRUE(table._shard_count == 16);
+
+            // Every thread walks all triangles so each shared edge is contended by every thread
+            std::vector<sg_u32> inserted(NUM_THREADS, 0);
+            std::vector<std::thread> threads;
+            for (sg_u32 t = 0; t < NUM_THREADS; ++t)
+            {
+                threads.emplace_back([&, t]()
+                {
+                    for (sg_u32 tri_idx = 0; tri_idx < num_tri; ++tri_idx)
+                    {
+                        sg_u32 i0 = vtx_idx_data[tri_idx * 3 + 0];
+                        sg_u32 i1 = vtx_idx_data[tri_idx * 3 + 1];
+                        sg_u32 i2 = vtx_idx_data[tri_idx * 3 + 2];
+
+                        edge edges[3] = { { i0, i1 }, { i0, i2 }, { i1, i2 } };
+                        for (sg_u32 e = 0; e < 3; ++e)
+                        {
+                            sg_u64 pair = edges[e].pair();
+                            inserted[t] += sg_concurrent_hash_table_insert_key(&table, &pair, &edges[e]);
+                        }
+                    }
+                });
+            }
+
+            for (std::thread& thread : threads)
+                thread.join();
+
+            sg_u32 num_edges = rows * (cols + 1) + cols * (rows + 1) + rows * cols;
+            sg_u32 total = 0;
+            for (sg_u32 t = 0; t < NUM_THREADS; ++t)
+                total += inserted[t];
+
+            ASSERT_TRUE(total == num_edges);
+            ASSERT_TRUE(sg_concurrent_hash_table_size(&table) == num_edges);
+
+            sg_concurrent_hash_table_freeze(&table);
+
+            std::vector<sg_u32> found(NUM_THREADS, 0);
+            threads.clear();
+            for (sg_u32 t = 0; t < NUM_THREADS; ++t)
+            {
+                threads.emplace_back([&, t]()
+                {
+                    for (sg_u32 tri_idx = t; tri_idx < num_tri; tri_idx += NUM_THREADS)
+                    {
+                        edge e0 = { vtx_idx_data[tri_idx * 3 + 0], vtx_idx_data[tri_idx * 3 + 1] };
+                        sg_u64 pair = e0.pair();
+
+                        edge value = { 0, 0 };
+                        if (sg_concurrent_hash_table_find_key_value(&table, &pair, &value) && value.pair() == pair)
+                            found[t] += 1;
+                    }
+                });
+            }
+
+            for (std::thread& thread : threads)
+                thread.join();
+
+            sg_concurrent_hash_table_thaw(&table);
+
+            total = 0;
+            for (sg_u32 t = 0; t < NUM_THREADS; ++t)
+                total += found[t];
+
+            ASSERT_TRUE(total == num_tri);
+
+            sg_u64 pair = edge(0, 1).pair();
+            ASSERT_TRUE(sg_concurrent_hash_table_remove_key(&table, &pair));
+            ASSERT_FALSE(sg_concurrent_hash_table_find_key(&table, &pair));
+            ASSERT_TRUE(sg_concurrent_hash_table_size(&table) == num_edges - 1);
+
+            sg_concurrent_hash_table_destroy(&table);
+            destroy_idx_buf_plane(vtx_idx_data);
+        }
+
+        TEST(sg_atomic_hash_table, counters)
+        {
+            const sg_u32 num_keys = 1000;
+            const sg_u32 num_adds = 100000;
+
+            sg_atomic_hash_table table = sg_atomic_hash_table_create(num_keys * 2, sizeof(sg_u32), NULL);
+
+            std::vector<std::thread> threads;
+            for (sg_u32 t = 0; t < NUM_THREADS; ++t)
+            {
+                threads.emplace_back([&, t]()
+                {
+                    for (sg_u32 i = 0; i < num_adds; ++i)
+                    {
+                        sg_u32* p_count = (sg_u32*)sg_atomic_hash_table_emplace(&table, (i * 7 + t) % num_keys);
+                        ASSERT_TRUE(p_count != NULL);
+                        sg_atomic_fetch_add_u32(p_count, 1);
+                    }
+                });
+            }
+
+            for (std::thread& thread : threads)
+                thread.join();
+
+            ASSERT_TRUE(sg_atomic_hash_table_size(&table) == num_keys);
+
+            sg_u32 total = 0;
+            for (sg_u32 key = 0; key < num_keys; ++key)
+            {
+                sg_u32* p_count = NULL;
+                ASSERT_TRUE(sg_atomic_hash_table_find_value(&table, key, (void**)&p_count));
+                total += *p_count;
+            }
+
+            ASSERT_TRUE(total == num_adds * NUM_THREADS);
+            ASSERT_FALSE(sg_atomic_hash_table_find(&table, num_keys));
+            ASSERT_TRUE(sg_atomic_hash_table_find_value(&table, 0, NULL));
+
+            sg_atomic_hash_table_destroy(&table);
+        }
+
+        TEST(sg_atomic_hash_table, full)
+        {
+            const sg_u32 capacity = 16;
+
+            sg_atomic_hash_table table = sg_atomic_hash_table_create(capacity, sizeof(sg_u32), NULL);
+
+            for (sg_u32 key = 0; key < capacity; ++key)
+                ASSERT_TRUE(sg_atomic_hash_table_emplace(&table, key * 31) != NULL);
+
+            // Existing keys still resolve once every slot is claimed, new ones fail
+            ASSERT_TRUE(sg_atomic_hash_table_emplace(&table, 31) != NULL);
+            ASSERT_TRUE(sg_atomic_hash_table_emplace(&table, 1) == NULL);
+            ASSERT_FALSE(sg_atomic_hash_table_find(&table, 1));
+            ASSERT_TRUE(sg_atomic_hash_table_size(&table) == capacity);
+
+            sg_atomic_hash_table_clear(&table);
+            ASSERT_TRUE(sg_atomic_hash_table_size(&table) == 0);
+            ASSERT_FALSE(sg_atomic_hash_table_find(&table, 31));
+
+            sg_atomic_hash_table_destroy(&table);
+        }
+
+        TEST(sg_arena, allocate_reset)
+        {
+            sg_arena arena = sg_arena_create(1024, NULL);
+
+            sg_u8* p_a = (sg_u8*)sg_arena_allocate(&arena, 24);
+            ASSERT_TRUE(((uintptr_t)p_a % SG_ARENA_ALIGNMENT) == 0);
+            memset(p_a, 0xaa, 24);
+
+            sg_arena_mark mark = sg_arena_get_mark(&arena);
+            sg_u64 size = sg_arena_size(&arena);
+
+            // Spill over a few chunks, including one larger than the chunk size
+            for (sg_u32 i = 0; i < 64; ++i)
+            {
+                void* p_b = sg_arena_allocate(&arena, 100);
+                ASSERT_TRUE(((uintptr_t)p_b % SG_ARENA_ALIGNMENT) == 0);
+                memset(p_b, i, 100);
+            }
+
+            void* p_large = sg_arena_allocate(&arena, 4096);
+            memset(p_large, 0xbb, 4096);
+            ASSERT_TRUE(sg_arena_size(&arena) > size + 64 * 100 + 4096);
+
+            sg_arena_reset(&arena, mark);
+            ASSERT_TRUE(sg_arena_size(&arena) == size);
+            for (sg_u32 i = 0; i < 24; ++i)
+                ASSERT_TRUE(p_a[i] == 0xaa);
+
+            // Reset chunks are reused before the parent is asked for more
+            sg_arena_chunk* p_free = arena._free;
+            ASSERT_TRUE(p_free != NULL);
+            sg_arena_allocate(&arena, 1000);
+            ASSERT_TRUE(arena._chunk == p_free);
+
+            // The top allocation is freed and resized in place
+            void* p_top = sg_arena_allocate(&arena, 8);
+            size = sg_arena_size(&arena);
+            ASSERT_TRUE(sg_arena_realloc(&arena, p_top, 4) == p_top);
+            ASSERT_TRUE(sg_arena_realloc(&arena, p_top, 8) == p_top);
+            sg_arena_free(&arena, p_top);
+            ASSERT_TRUE(sg_arena_size(&arena) < size);
+
+            sg_arena_clear(&arena);
+            ASSERT_TRUE(sg_arena_size(&arena) == 0);
+            ASSERT_TRUE(arena._chunk == NULL);
+
+            sg_arena_destroy(&arena);
+            ASSERT_TRUE(arena._free == NULL);
+        }
+
+        TEST(sg_arena, containers)
+        {
+            sg_arena arena = sg_arena_create(0, NULL);
+            sg_allocator allocator = sg_arena_allocator(&arena);
+
+            for (sg_u32 frame = 0; frame < 4; ++frame)
+            {
+                sg_vector vector = sg_vector_create(0, sizeof(sg_u32), &allocator);
+                sg_hash_table table = sg_hash_table_create(0, sizeof(sg_u32), HASH_TABLE_LOAD_FACTOR, &allocator);
+
+                for (sg_u32 i = 0; i < VECTOR_SIZE; ++i)
+                {
+                    sg_vector_push(&vector, &i);
+                    sg_hash_table_insert(&table, i, &i);
+                }
+
+                for (sg_u32 i = 0; i < VECTOR_SIZE; ++i)
+                {
+                    sg_u32* p_value = NULL;
+                    ASSERT_TRUE(*(sg_u32*)sg_vector_data(&vector, i) == i);
+                    ASSERT_TRUE(sg_hash_table_find_value(&table, i, (void**)&p_value));
+                    ASSERT_TRUE(*p_value == i);
+                }
+
+                // Frame scratch is dropped wholesale instead of destroying each container
+                sg_arena_clear(&arena);
+            }
+
+            sg_arena_destroy(&arena);
+        }
+
+        TEST(sg_pool_allocator, reuse)
+        {
+            sg_pool_allocator pool = sg_pool_allocator_create(1024, NULL);
+
+            void* p_blocks[64];
+            for (sg_u32 i = 0; i < 64; ++i)
+            {
+                p_blocks[i] = sg_pool_allocator_allocate(&pool, 24);
+                ASSERT_TRUE(((uintptr_t)p_blocks[i] % 16) == 0);
+                memset(p_blocks[i], i, 24);
+            }
+
+            for (sg_u32 i = 0; i < 64; ++i)
+                for (sg_u32 j = 0; j < 24; ++j)
+                    ASSERT_TRUE(((sg_u8*)p_blocks[i])[j] == i);
+
+            // Freed blocks come back last in first out, and sizes in the same class share them
+            sg_pool_allocator_free(&pool, p_blocks[3]);
+            sg_pool_allocator_free(&pool, p_blocks[7]);
+            ASSERT_TRUE(sg_pool_allocator_allocate(&pool, 32) == p_blocks[7]);
+            ASSERT_TRUE(sg_pool_allocator_allocate(&pool, 17) == p_blocks[3]);
+
+            // Growing within the class keeps the block, past it moves and copies
+            ASSERT_TRUE(sg_pool_allocator_realloc(&pool, p_blocks[0], 30) == p_blocks[0]);
+            sg_u8* p_moved = (sg_u8*)sg_pool_allocator_realloc(&pool, p_blocks[0], 100);
+            ASSERT_TRUE(p_moved != p_blocks[0]);
+            for (sg_u32 j = 0; j < 24; ++j)
+                ASSERT_TRUE(p_moved[j] == 0);
+            ASSERT_TRUE(sg_pool_allocator_allocate(&pool, 20) == p_blocks[0]);
+
+            // Oversized requests fall back to the parent
+            sg_u64 large = sg_pool_allocator_max_block() + 1;
+            sg_u8* p_large = (sg_u8*)sg_pool_allocator_allocate(&pool, large);
+            memset(p_large, 0xcc, large);
+            p_large = (sg_u8*)sg_pool_allocator_realloc(&pool, p_large, large * 2);
+            ASSERT_TRUE(p_large[large - 1] == 0xcc);
+            sg_pool_allocator_free(&pool, p_large);
+
+            sg_pool_allocator_destroy(&pool);
+            ASSERT_TRUE(pool._slabs == NULL);
+        }
+
+        TEST(sg_pool_allocator, destroy_large)
+        {
+            sg_tracking_allocator tracker = sg_tracking_allocator_create(NULL);
+            sg_allocator parent = sg_tracking_allocator_allocator(&tracker, 0);
+            sg_pool_allocator pool = sg_pool_allocator_create(0, &parent);
+
+            // Oversized blocks still in use at destroy go back to the parent with the slabs
+            sg_u64 large = sg_pool_allocator_max_block() + 1;
+            void* p_blocks[4];
+            for (sg_u32 i = 0; i < 4; ++i)
+            {
+                p_blocks[i] = sg_pool_allocator_allocate(&pool, large);
+                ASSERT_TRUE(((uintptr_t)p_blocks[i] % 16) == 0);
+            }
+
+            sg_pool_allocator_free(&pool, p_blocks[1]);
+            p_blocks[2] = sg_pool_allocator_realloc(&pool, p_blocks[2], large * 4);
+            sg_pool_allocator_allocate(&pool, 24);
+
+            sg_pool_allocator_destroy(&pool);
+            ASSERT_TRUE(sg_tracking_allocator_total(&tracker).live_bytes == 0);
+            sg_tracking_allocator_destroy(&tracker);
+        }
+
+        TEST(sg_pool_allocator, containers)
+        {
+            sg_pool_allocator pool = sg_pool_allocator_create(0, NULL);
+            sg_allocator allocator = sg_pool_allocator_allocator(&pool);
+
+            std::vector<sg_vector> vectors;
+            for (sg_u32 v = 0; v < 32; ++v)
+            {
+                sg_vector vector = sg_vector_create(0, sizeof(sg_u32), &allocator);
+                for (sg_u32 i = 0; i < v * 16; ++i)
+                    sg_vector_push(&vector, &i);
+
+                vectors.push_back(vector);
+            }
+
+            for (sg_u32 v = 0; v < 32; ++v)
+            {
+                ASSERT_TRUE(sg_vector_size(&vectors[v]) == v * 16);
+                for (sg_u32 i = 0; i < v * 16; ++i)
+                    ASSERT_TRUE(*(sg_u32*)sg_vector_data(&vectors[v], i) == i);
+
+                sg_vector_destroy(&vectors[v]);
+            }
+
+            sg_pool_allocator_destroy(&pool);
+        }
+
+        TEST(sg_thread_cache_allocator, reuse)
+        {
+            sg_thread_cache_allocator allocator = sg_thread_cache_allocator_create(0, NULL);
+
+            void* p_a = sg_thread_cache_allocator_allocate(&allocator, 40);
+            void* p_b = sg_thread_cache_allocator_allocate(&allocator, 40);
+            ASSERT_TRUE(((uintptr_t)p_a % 16) == 0);
+
+            sg_thread_cache_allocator_free(&allocator, p_a);
+            sg_thread_cache_allocator_free(&allocator, p_b);
+            ASSERT_TRUE(sg_thread_cache_allocator_allocate(&allocator, 64) == p_b);
+            ASSERT_TRUE(sg_thread_cache_allocator_allocate(&allocator, 33) == p_a);
+
+            ASSERT_TRUE(sg_thread_cache_allocator_realloc(&allocator, p_a, 60) == p_a);
+            memset(p_a, 0x5a, 60);
+            sg_u8* p_moved = (sg_u8*)sg_thread_cache_allocator_realloc(&allocator, p_a, 4096);
+            ASSERT_TRUE(p_moved[59] == 0x5a);
+
+            sg_thread_cache_allocator_free(&allocator, p_moved);
+            sg_thread_cache_allocator_free(&allocator, p_b);
+            sg_thread_cache_allocator_destroy(&allocator);
+        }
+
+        TEST(sg_thread_cache_allocator, many_allocators)
+        {
+            // More allocators than slots, each one keeps a single cache for this thread
+            const sg_u32 num_allocators = SG_THREAD_CACHE_SLOTS * 2 + 1;
+            std::vector<sg_thread_cache_allocator> allocators(num_allocators);
+            for (sg_thread_cache_allocator& allocator : allocators)
+                allocator = sg_thread_cache_allocator_create(0, NULL);
+
+            std::vector<void*> previous(num_allocators, nullptr);
+            for (sg_u32 round = 0; round < 100; ++round)
+            {
+                for (sg_u32 a = 0; a < num_allocators; ++a)
+                {
+                    void* p_block = sg_thread_cache_allocator_allocate(&allocators[a], 48);
+                    ASSERT_TRUE(round == 0 || p_block == previous[a]);
+                    previous[a] = p_block;
+                    sg_thread_cache_allocator_free(&allocators[a], p_block);
+                }
+            }
+
+            for (sg_thread_cache_allocator& allocator : allocators)
+            {
+                ASSERT_TRUE(allocator._caches != NULL && allocator._caches->_next == NULL);
+                sg_thread_cache_allocator_destroy(&allocator);
+            }
+        }
+
+        TEST(sg_thread_cache_allocator, remote_free)
+        {
+            const sg_u32 num_blocks = 1000;
+
+            sg_thread_cache_allocator cache_allocator = sg_thread_cache_allocator_create(num_blocks * 2, NULL);
+            sg_allocator allocator = sg_thread_cache_allocator_allocator(&cache_allocator);
+
+            std::vector<std::vector<void*>> blocks(NUM_THREADS);
+            std::vector<sg_vector> vectors(NUM_THREADS);
+            std::vector<sg_u32> reused(NUM_THREADS, 0);
+
+            // Caches belong to threads so every phase runs on the same workers
+            std::atomic<sg_u32> arrived(0);
+            auto barrier = [&](sg_u32 phase)
+            {
+                arrived.fetch_add(1);
+                while (arrived.load() < phase * NUM_THREADS)
+                    std::this_thread::yield();
+            };
+
+            std::vector<std::thread> threads;
+            for (sg_u32 t = 0; t < NUM_THREADS; ++t)
+            {
+                threads.emplace_back([&, t]()
+                {
+                    // Each thread allocates blocks and fills a vector
+                    for (sg_u32 i = 0; i < num_blocks; ++i)
+                        blocks[t].push_back(sg_thread_cache_allocator_allocate(&cache_allocator, 32));
+
+                    vectors[t] = sg_vector_create(0, sizeof(sg_u32), &allocator);
+                    for (sg_u32 i = 0; i < VECTOR_SIZE; ++i)
+                        sg_vector_push(&vectors[t], &i);
+
+                    barrier(1);
+
+                    // Then frees the blocks and vector of its neighbour
+                    sg_u32 n = (t + 1) % NUM_THREADS;
+                    for (sg_u32 i = 0; i < VECTOR_SIZE; ++i)
+                        EXPECT_TRUE(*(sg_u32*)sg_vector_data(&vectors[n], i) == i);
+
+                    sg_vector_destroy(&vectors[n]);
+                    for (void* p_block : blocks[n])
+                        sg_thread_cache_allocator_free(&cache_allocator, p_block);
+
+                    sg_thread_cache_allocator_flush(&cache_allocator);
+                    barrier(2);
+
+                    // Blocks freed remotely come back to the thread that first allocated them
+                    std::vector<void*> previous = blocks[t];
+                    std::sort(previous.begin(), previous.end());
+                    barrier(3);
+
+                    // A few blocks of the same class freed locally by vector growth come first
+                    blocks[t].clear();
+                    for (sg_u32 i = 0; i < num_blocks + 8; ++i)
+                    {
+                        void* p_block = sg_thread_cache_allocator_allocate(&cache_allocator, 32);
+                        if (std::binary_search(previous.begin(), previous.end(), p_block))
+                            reused[t] += 1;
+
+                        blocks[t].push_back(p_block);
+                    }
+
+                    for (void* p_block : blocks[t])
+                        sg_thread_cache_allocator_free(&cache_allocator, p_block);
+                });
+            }
+
+            for (std::thread& thread : threads)
+                thread.join();
+
+            for (sg_u32 t = 0; t < NUM_THREADS; ++t)
+                ASSERT_TRUE(reused[t] == num_blocks);
+
+            sg_thread_cache_allocator_destroy(&cache_allocator);
+        }
+
+        TEST(sg_tracking_allocator, stats)
+        {
+            sg_tracking_allocator tracker = sg_tracking_allocator_create(NULL);
+            sg_u32 vector_tag = sg_tracking_allocator_add_tag(&tracker, "vectors");
+            sg_u32 table_tag = sg_tracking_allocator_add_tag(&tracker, "tables");
+            sg_allocator vector_allocator = sg_tracking_allocator_allocator(&tracker, vector_tag);
+            sg_allocator table_allocator = sg_tracking_allocator_allocator(&tracker, table_tag);
+
+            sg_vector vector = sg_vector_create(0, sizeof(sg_u32), &vector_allocator);
+            sg_vector aligned = sg_vector_create_aligned(0, sizeof(sg_u32), 64, &vector_allocator);
+            sg_hash_table table = sg_hash_table_create(0, sizeof(sg_u32), HASH_TABLE_LOAD_FACTOR, &table_allocator);
+
+            sg_u32 num_growths = 0;
+            for (sg_u32 i = 0; i < VECTOR_SIZE; ++i)
+            {
+                sg_u32 capacity = vector._capacity;
+                sg_vector_push(&vector, &i);
+                sg_vector_push(&aligned, &i);
+                sg_hash_table_insert(&table, i, &i);
+                num_growths += vector._capacity != capacity;
+            }
+
+            // Every growth of either vector is one call into the allocator
+            sg_allocation_stats stats = sg_tracking_allocator_stats(&tracker, vector_tag);
+            ASSERT_TRUE(((uintptr_t)aligned._buffer.allocation % 64) == 0);
+            ASSERT_TRUE(stats.live_bytes == (vector._capacity + aligned._capacity) * sizeof(sg_u32));
+            ASSERT_TRUE(stats.peak_bytes >= stats.live_bytes);
+            ASSERT_TRUE(stats.allocations == 2);
+            ASSERT_TRUE(stats.reallocations == 2 * (num_growths - 1));
+            ASSERT_TRUE(stats.histogram[14] == 2);
+
+            sg_allocation_stats table_stats = sg_tracking_allocator_stats(&tracker, table_tag);
+            ASSERT_TRUE(table_stats.allocations > 0);
+            ASSERT_TRUE(table_stats.frees > 0);
+
+            sg_vector_destroy(&vector);
+            sg_vector_destroy(&aligned);
+            sg_hash_table_destroy(&table);
+
+            sg_allocation_stats total = sg_tracking_allocator_total(&tracker);
+            ASSERT_TRUE(total.live_bytes == 0);
+            ASSERT_TRUE(total.peak_bytes >= stats.peak_bytes);
+            ASSERT_TRUE(total.allocations == total.frees);
+            ASSERT_TRUE(sg_tracking_allocator_stats(&tracker, SG_TRACKING_ALLOCATOR_TAG_NONE).allocations == 0);
+
+            FILE* p_file = tmpfile();
+            sg_tracking_allocator_dump(&tracker, p_file);
+            rewind(p_file);
+
+            char sz_dump[4096] = {};
+            fread(sz_dump, 1, sizeof(sz_dump) - 1, p_file);
+            fclose(p_file);
+            ASSERT_TRUE(strstr(sz_dump, "vectors: live 0") != NULL);
+            ASSERT_TRUE(strstr(sz_dump, "tables: live 0") != NULL);
+
+            sg_tracking_allocator_destroy(&tracker);
+        }
+
+        TEST(sg_snapshot, vector)
+        {
+            const char* path = "sg_snapshot_vector.bin";
+
+            sg_vector vector = sg_vector_create(0, sizeof(sg_u32), NULL);
+            for (sg_u32 i = 0; i < VECTOR_SIZE; ++i)
+                sg_vector_push(&vector, &i);
+
+            ASSERT_TRUE(sg_vector_save(&vector, path));
+            sg_vector_destroy(&vector);
+
+            ASSERT_TRUE(sg_vector_load(&vector, path, NULL));
+            ASSERT_TRUE(sg_vector_size(&vector) == VECTOR_SIZE);
+            for (sg_u32 i = 0; i < VECTOR_SIZE; ++i)
+                ASSERT_TRUE(*(sg_u32*)sg_vector_data(&vector, i) == i);
+
+            // A size that does not match the payload is refused before allocating it
+            ASSERT_TRUE(sg_vector_save(&vector, path));
+            sg_vector_destroy(&vector);
+            sg_u32 size = 0x40000000;
+            FILE* p_file = fopen(path, "r+b");
+            fseek(p_file, (long)offsetof(sg_snapshot_header, params), SEEK_SET);
+            fwrite(&size, sizeof(sg_u32), 1, p_file);
+            fclose(p_file);
+            ASSERT_FALSE(sg_vector_load(&vector, path, NULL));
+
+            // A table snapshot is not a vector
+            sg_hash_table table = sg_hash_table_create(0, sizeof(sg_u32), HASH_TABLE_LOAD_FACTOR, NULL);
+            ASSERT_TRUE(sg_hash_table_save(&table, path));
+            ASSERT_FALSE(sg_vector_load(&vector, path, NULL));
+            sg_hash_table_destroy(&table);
+
+            remove(path);
+            ASSERT_FALSE(sg_vector_load(&vector, path, NULL));
+        }
+
+        TEST(sg_snapshot, hash_table)
+        {
+            const char* path = "sg_snapshot_hash_table.bin";
+
+            // Save mid resize to cover the pending migration
+            sg_hash_table table = sg_hash_table_create(0, sizeof(sg_u32), HASH_TABLE_LOAD_FACTOR, NULL);
+            sg_hash_table_set_incremental(&table, 1);
+            for (sg_u32 i = 0; i < HASH_TABLE_SIZE; ++i)
+            {
+                sg_u32 value = i * 3;
+                sg_hash_table_insert(&table, i, &value);
+            }
+
+            sg_hash_table_remove(&table, 7);
+            ASSERT_TRUE(sg_hash_table_save(&table, path));
+
+            sg_hash_table loaded;
+            ASSERT_TRUE(sg_hash_table_load(&loaded, path, NULL, NULL, NULL));
+            ASSERT_TRUE(sg_hash_table_size(&loaded) == HASH_TABLE_SIZE - 1);
+            ASSERT_TRUE(sg_hash_table_capacity(&loaded) == sg_hash_table_capacity(&table));
+            ASSERT_TRUE(loaded._load_factor == table._load_factor);
+            ASSERT_FALSE(sg_hash_table_find(&loaded, 7));
+
+            for (sg_u32 i = 0; i < HASH_TABLE_SIZE; ++i)
+            {
+                sg_u32* p_value = NULL;
+                if (i == 7) continue;
+                ASSERT_TRUE(sg_hash_table_find_value(&loaded, i, (void**)&p_value));
+                ASSERT_TRUE(*p_value == i * 3);
+            }
+
+            // Loaded tables keep growing like built ones
+            for (sg_u32 i = HASH_TABLE_SIZE; i < HASH_TABLE_SIZE * 2; ++i)
+                sg_hash_table_insert(&loaded, i, &i);
+            ASSERT_TRUE(sg_hash_table_find(&loaded, HASH_TABLE_SIZE * 2 - 1));
+
+            // The callbacks have to match
+            sg_hash_table other;
+            ASSERT_FALSE(sg_hash_table_load(&other, path, tri_key_hash, NULL, NULL));
+
+            // Any flipped byte fails the checksum
+            FILE* p_file = fopen(path, "r+b");
+            fseek(p_file, -5, SEEK_END);
+            int c = fgetc(p_file);
+            fseek(p_file, -5, SEEK_END);
+            fputc(c ^ 0x10, p_file);
+            fclose(p_file);
+            ASSERT_FALSE(sg_hash_table_load(&other, path, NULL, NULL, NULL));
+
+            // So does a changed header param, and ones that could not index the slots are refused up front
+            auto load_patched = [&](sg_u32 param, sg_u32 value)
+            {
+                EXPECT_TRUE(sg_hash_table_save(&table, path));
+                FILE* p_patch = fopen(path, "r+b");
+                fseek(p_patch, (long)(offsetof(sg_snapshot_header, params) + param * sizeof(sg_u32)), SEEK_SET);
+                fwrite(&value, sizeof(sg_u32), 1, p_patch);
+                fclose(p_patch);
+                return sg_hash_table_load(&other, path, NULL, NULL, NULL);
+            };
+
+            sg_f32 load_factor = table._load_factor * 0.5f;
+            sg_u32 load_factor_bits = 0;
+            memcpy(&load_factor_bits, &load_factor, sizeof(sg_f32));
+            ASSERT_FALSE(load_patched(5, load_factor_bits));
+            ASSERT_FALSE(load_patched(4, 32));
+            ASSERT_FALSE(load_patched(0, sg_hash_table_capacity(&table) + SG_HASH_TABLE_GROUP_WIDTH));
+            ASSERT_FALSE(load_patched(1, sg_hash_table_capacity(&table) + 1));
+
+            remove(path);
+            sg_hash_table_destroy(&loaded);
+            sg_hash_table_destroy(&table);
+        }
+
+        TEST(sg_snapshot, hash_table_capacity)
+        {
+            const char* path = "sg_snapshot_hash_table_capacity.bin";
+
+            // Capacities are whatever create and reserve asked for, not only powers of two
+            sg_hash_table created = sg_hash_table_create(100, sizeof(sg_u32), HASH_TABLE_LOAD_FACTOR, NULL);
+            sg_hash_table reserved = sg_hash_table_create(0, sizeof(sg_u32), HASH_TABLE_LOAD_FACTOR, NULL);
+            sg_hash_table_reserve(&reserved, 1000);
+
+            sg_hash_table* tables[] = { &created, &reserved };
+            for (sg_hash_table* p_table : tables)
+            {
+                ASSERT_TRUE((sg_hash_table_capacity(p_table) & (sg_hash_table_capacity(p_table) - 1)) != 0);
+                for (sg_u32 i = 0; i < 50; ++i)
+                    sg_hash_table_insert(p_table, i * 7, &i);
+
+                ASSERT_TRUE(sg_hash_table_save(p_table, path));
+
+                sg_hash_table loaded;
+                ASSERT_TRUE(sg_hash_table_load(&loaded, path, NULL, NULL, NULL));
+                ASSERT_TRUE(sg_hash_table_capacity(&loaded) == sg_hash_table_capacity(p_table));
+                ASSERT_TRUE(sg_hash_table_size(&loaded) == 50);
+                for (sg_u32 i = 0; i < 50; ++i)
+                {
+                    sg_u32* p_value = NULL;
+                    ASSERT_TRUE(sg_hash_table_find_value(&loaded, i * 7, (void**)&p_value));
+                    ASSERT_TRUE(*p_value == i);
+                }
+
+                sg_hash_table_destroy(&loaded);
+                sg_hash_table_destroy(p_table);
+            }
+
+            remove(path);
+        }
+
+        TEST(sg_stream, open_failure)
+        {
+            const char* path = "sg_stream_open_failure.bin";
+
+            // Chunks that can not be allocated fail the open without leaking the file
+            sg_allocator failing = s_allocator_default;
+            failing.allocate = [](sg_u64, void*) -> void* { return NULL; };
+
+            sg_stream_writer writer;
+            ASSERT_FALSE(sg_stream_writer_open(&writer, path, 0, &failing));
+            ASSERT_TRUE(writer._file == NULL);
+
+            ASSERT_TRUE(sg_stream_writer_open(&writer, path, 0, NULL));
+            ASSERT_TRUE(sg_stream_writer_close(&writer));
+
+            sg_stream_reader reader;
+            ASSERT_FALSE(sg_stream_reader_open(&reader, path, sizeof(sg_u32), 0, &failing));
+            ASSERT_TRUE(reader._file == NULL);
+            remove(path);
+        }
+
+        TEST(sg_stream, round_trip)
+        {
+            const char* path = "sg_stream_round_trip.bin";
+            struct element { sg_u32 a, b, c; };
+
+            // Chunks smaller than the data and not a multiple of the element stride
+            const sg_u64 chunk_size = 1000;
+
+            sg_vector vector = sg_vector_create(0, sizeof(element), NULL);
+            for (sg_u32 i = 0; i < VECTOR_SIZE; ++i)
+            {
+                element e = { i, i * 2, i * 3 };
+                sg_vector_push(&vector, &e);
+            }
+
+            sg_stream_writer writer;
+            ASSERT_TRUE(sg_stream_writer_open(&writer, path, chunk_size, NULL));
+            sg_stream_writer_write_vector(&writer, &vector);
+
+            sg_u32 offset = 0;
+            while (offset < VECTOR_SIZE)
+            {
+                sg_u32 count = std::min(37U, VECTOR_SIZE - offset);
+                sg_slice slice = sg_slice_make(sg_vector_data(&vector, 0), offset, count, sizeof(element));
+                sg_stream_writer_write_slice(&writer, &slice);
+                offset += count;
+            }
+
+            ASSERT_TRUE(sg_stream_writer_close(&writer));
+            sg_vector_destroy(&vector);
+
+            sg_stream_reader reader;
+            ASSERT_TRUE(sg_stream_reader_open(&reader, path, sizeof(element), chunk_size, NULL));
+
+            sg_u32 total = 0;
+            sg_slice slice;
+            while (sg_stream_reader_next(&reader, &slice))
+            {
+                ASSERT_TRUE(sg_slice_size(&slice) * sizeof(element) <= chunk_size);
+                for (sg_u32 i = 0; i < sg_slice_size(&slice); ++i)
+                {
+                    element* p_e = (element*)sg_slice_data(&slice, i);
+                    sg_u32 expected = total % VECTOR_SIZE;
+                    ASSERT_TRUE(p_e->a == expected && p_e->b == expected * 2 && p_e->c == expected * 3);
+                    total += 1;
+                }
+            }
+
+            ASSERT_TRUE(total == VECTOR_SIZE * 2);
+            ASSERT_FALSE(sg_stream_reader_next(&reader, &slice));
+            ASSERT_TRUE(sg_stream_reader_close(&reader));
+
+            remove(path);
+            ASSERT_FALSE(sg_stream_reader_open(&reader, path, sizeof(element), chunk_size, NULL));
+        }
+
+        TEST(sg_parallel, for_each_transform_reduce)
+        {
+            const sg_u32 count = 1024 * 1024 + 17;
+
+            sg_vector input = sg_vector_create(count, sizeof(sg_u32), NULL);
+            sg_vector output = sg_vector_create(count, sizeof(sg_u64), NULL);
+            sg_slice input_slice = sg_vector_to_slice(&input, 0, count);
+            sg_slice output_slice = sg_vector_to_slice(&output, 0, count);
+
+            sg_parallel_pool pool = sg_parallel_pool_create(NUM_THREADS, NULL);
+            sg_u64 scale = 3;
+
+            // Small grains force plenty of splitting and stealing
+            sg_u32 grains[] = { 0, 7, 1000 };
+            for (sg_u32 grain : grains)
+            {
+                sg_parallel_for_each(&pool, &input_slice, grain, [](sg_slice* p_chunk, sg_u32 offset, void*)
+                {
+                    for (sg_u32 i = 0; i < p_chunk->_count; ++i)
+                        *(sg_u32*)sg_slice_data(p_chunk, i) = offset + i;
+                }, NULL);
+
+                sg_parallel_transform(&pool, &input_slice, &output_slice, grain, [](sg_slice* p_input, sg_slice* p_output, sg_u32, void* p_user_data)
+                {
+                    sg_u64 scale = *(sg_u64*)p_user_data;
+                    for (sg_u32 i = 0; i < p_input->_count; ++i)
+                        *(sg_u64*)sg_slice_data(p_output, i) = *(sg_u32*)sg_slice_data(p_input, i) * scale;
+                }, &scale);
+
+                for (sg_u32 i = 0; i < count; ++i)
+                {
+                    ASSERT_TRUE(*(sg_u32*)sg_vector_data(&input, i) == i);
+                    ASSERT_TRUE(*(sg_u64*)sg_vector_data(&output, i) == (sg_u64)i * 3);
+                }
+
+                sg_u64 sum = 0;
+                sg_parallel_reduce(&pool, &output_slice, grain, &sum, sizeof(sum), [](sg_slice* p_chunk, void* p_accumulator, void*)
+                {
+                    for (sg_u32 i = 0; i < p_chunk->_count; ++i)
+                        *(sg_u64*)p_accumulator += *(sg_u64*)sg_slice_data(p_chunk, i);
+                }, [](void* p_accumulator, const void* p_other, void*)
+                {
+                    *(sg_u64*)p_accumulator += *(const sg_u64*)p_other;
+                }, NULL);
+
+                ASSERT_TRUE(sum == (sg_u64)count * (count - 1) / 2 * 3);
+            }
+
+            // Calls from several threads take turns on the pool
+            std::atomic<sg_u32> total(0);
+            std::vector<std::thread> threads;
+            for (sg_u32 t = 0; t < NUM_THREADS; ++t)
+            {
+                threads.emplace_back([&]()
+                {
+                    sg_parallel_for_each(&pool, &input_slice, 64, [](sg_slice* p_chunk, sg_u32, void* p_user_data)
+                    {
+                        ((std::atomic<sg_u32>*)p_user_data)->fetch_add(p_chunk->_count);
+                    }, &total);
+                });
+            }
+
+            for (std::thread& thread : threads)
+                thread.join();
+
+            ASSERT_TRUE(total == count * NUM_THREADS);
+
+            sg_parallel_pool_destroy(&pool);
+
+            // Without a pool everything runs on the caller
+            sg_u64 sum = 0;
+            sg_parallel_reduce(NULL, &output_slice, 0, &sum, sizeof(sum), [](sg_slice* p_chunk, void* p_accumulator, void*)
+            {
+                for (sg_u32 i = 0; i < p_chunk->_count; ++i)
+                    *(sg_u64*)p_accumulator += *(sg_u64*)sg_slice_data(p_chunk, i);
+            }, NULL, NULL);
+            ASSERT_TRUE(sum == (sg_u64)count * (count - 1) / 2 * 3);
+
+            sg_vector_destroy(&output);
+            sg_vector_destroy(&input);
+        }
+
+        TEST(sg_sort, radix)
+        {
+            const sg_u32 count = 1024 * 1024 + 3;
+            std::mt19937_64 rng(7);
+
+            sg_parallel_pool pool = sg_parallel_pool_create(NUM_THREADS, NULL);
+            sg_parallel_pool* pools[] = { NULL, &pool };
+            for (sg_parallel_pool* p_pool : pools)
+            {
+                // The top digit is the same for every key so that pass is skipped
+                std::vector<sg_u32> keys32(count);
+                for (sg_u32 i = 0; i < count; ++i)
+                    keys32[i] = (sg_u32)rng() & 0xFFFFFF;
+
+                std::vector<sg_u32> expected32 = keys32;
+                std::sort(expected32.begin(), expected32.end());
+
+                sg_slice slice = sg_slice_make(keys32.data(), 0, count, sizeof(sg_u32));
+                sg_sort_radix_u32(p_pool, &slice, NULL);
+                ASSERT_TRUE(keys32 == expected32);
+
+                std::vector<sg_u64> keys64(count);
+                for (sg_u32 i = 0; i < count; ++i)
+                    keys64[i] = rng();
+
+                std::vector<sg_u64> expected64 = keys64;
+                std::sort(expected64.begin(), expected64.end());
+
+                slice = sg_slice_make(keys64.data(), 0, count, sizeof(sg_u64));
+                sg_sort_radix_u64(p_pool, &slice, NULL);
+                ASSERT_TRUE(keys64 == expected64);
+            }
+
+            sg_parallel_pool_destroy(&pool);
+        }
+
+        TEST(sg_sort, radix_payload)
+        {
+            // Key in the middle of a 12 byte element, the payload records the original order
+            struct element { sg_u32 before; sg_u32 key; sg_u32 index; };
+            const sg_u32 count = 200000;
+            std::mt19937 rng(11);
+
+            sg_vector vector = sg_vector_create(count, sizeof(element), NULL);
+            for (sg_u32 i = 0; i < count; ++i)
+            {
+                element* p_e = (element*)sg_vector_data(&vector, i);
+                p_e->key = rng() % 1000;
+                p_e->before = p_e->key * 3;
+                p_e->index = i;
+            }
+
+            sg_parallel_pool pool = sg_parallel_pool_create(NUM_THREADS, NULL);
+            sg_slice slice = sg_vector_to_slice(&vector, 0, count);
+            sg_sort_radix(&pool, &slice, offsetof(element, key), sizeof(sg_u32), NULL);
+            sg_parallel_pool_destroy(&pool);
+
+            for (sg_u32 i = 0; i < count; ++i)
+            {
+                element* p_e = (element*)sg_vector_data(&vector, i);
+                ASSERT_TRUE(p_e->before == p_e->key * 3);
+                if (i == 0)
+                    continue;
+
+                // Equal keys keep their original order
+                element* p_prev = (element*)sg_vector_data(&vector, i - 1);
+                ASSERT_TRUE(p_prev->key < p_e->key || (p_prev->key == p_e->key && p_prev->index < p_e->index));
+            }
+
+            sg_vector_destroy(&vector);
+        }
+    }
+}
\ No newline at end of file